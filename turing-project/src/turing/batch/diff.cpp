@@ -0,0 +1,142 @@
+#include "turing/batch/diff.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "turing/batch/inputs.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+
+namespace turing::batch {
+
+namespace {
+
+// inputs claimed by a worker at a time
+constexpr size_t CHUNK = 1024;
+
+std::vector<char> sharedSymbols(const turing::machine::Machine &left,
+                                const turing::machine::Machine &right) {
+  std::vector<char> symbols;
+  for (char symbol : left.inputAlphabet()) {
+    if (right.inputAlphabet().contains(symbol)) {
+      symbols.push_back(symbol);
+    }
+  }
+  std::sort(symbols.begin(), symbols.end());
+  return symbols;
+}
+
+template <typename Inputs>
+DiffReport diffOver(const Inputs &inputs, const turing::machine::Machine &left,
+                    const turing::machine::Machine &right,
+                    const DiffOption &option) {
+  std::atomic<size_t> next = 0;
+  std::atomic<size_t> firstDiff = std::numeric_limits<size_t>::max();
+  std::atomic<size_t> checked = 0;
+  std::atomic<size_t> undecided = 0;
+
+  auto work = [&]() {
+    std::string input;
+    size_t localChecked = 0;
+    size_t localUndecided = 0;
+
+    for (size_t begin = next.fetch_add(CHUNK);
+         begin < inputs.size() && begin < firstDiff;
+         begin = next.fetch_add(CHUNK)) {
+      size_t end = std::min(begin + CHUNK, inputs.size());
+
+      for (size_t i = begin; i < end && i < firstDiff; ++i) {
+        inputs.at(i, input);
+        Outcome a = run(left, input, option.maxSteps);
+        Outcome b = run(right, input, option.maxSteps);
+
+        if (!a.halted || !b.halted) {
+          ++localUndecided;
+          continue;
+        }
+        ++localChecked;
+
+        if (a != b) {
+          // keep the smallest differing index across workers
+          size_t current = firstDiff;
+          while (i < current && !firstDiff.compare_exchange_weak(current, i)) {
+          }
+          break;
+        }
+      }
+    }
+
+    checked += localChecked;
+    undecided += localUndecided;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < std::max<size_t>(option.nThread, 1); ++i) {
+    workers.emplace_back(work);
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  DiffReport report{
+      .checked = checked,
+      .undecided = undecided,
+      .seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count(),
+  };
+
+  if (firstDiff != std::numeric_limits<size_t>::max()) {
+    std::string input;
+    inputs.at(firstDiff, input);
+    report.left = run(left, input, option.maxSteps);
+    report.right = run(right, input, option.maxSteps);
+    report.input = std::move(input);
+  }
+
+  return report;
+}
+
+} // namespace
+
+DiffReport diff(const turing::machine::Machine &left,
+                const turing::machine::Machine &right,
+                const DiffOption &option) {
+  std::vector<char> symbols = sharedSymbols(left, right);
+
+  if (option.randomInputs > 0) {
+    return diffOver(RandomInputs{symbols, option.maxLength,
+                                 option.randomInputs, option.seed},
+                    left, right, option);
+  }
+  return diffOver(ShortlexInputs{symbols, option.maxLength}, left, right,
+                  option);
+}
+
+Outcome run(const turing::machine::Machine &machine, const std::string &input,
+            size_t maxSteps) {
+  turing::machine::Execution execution{machine, input};
+  while (!execution.isHalted() && execution.tapes().steps() < maxSteps) {
+    execution.step();
+  }
+
+  if (!execution.isHalted()) {
+    return {.halted = false, .accepted = false, .content = ""};
+  }
+
+  const turing::machine::Tapes &tapes = execution.tapes();
+  return {
+      .halted = true,
+      .accepted = tapes.isAccepted(),
+      .content = tapes.content().value_or(""),
+  };
+}
+
+} // namespace turing::batch
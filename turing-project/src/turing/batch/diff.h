@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "turing/machine/machine.h"
+
+namespace turing::batch {
+
+struct DiffOption {
+  size_t maxLength;    // longest input tried
+  size_t randomInputs; // 0 tries every input in shortlex order
+  uint64_t seed;
+  size_t maxSteps;     // per run, runs over budget are undecided
+  size_t nThread;
+};
+
+// what one run ended with
+struct Outcome {
+  bool halted;
+  bool accepted;
+  std::string content;
+
+  bool operator==(const Outcome &other) const = default;
+};
+
+struct DiffReport {
+  size_t checked;   // inputs both machines halted on
+  size_t undecided; // inputs a machine did not halt on within maxSteps
+  double seconds;
+  // the first input, in enumeration order, the machines disagree on
+  std::optional<std::string> input;
+  Outcome left;
+  Outcome right;
+};
+
+// Run both machines on inputs over the symbols both accept as input and
+// compare acceptance and the content of tape 0.
+DiffReport diff(const turing::machine::Machine &left,
+                const turing::machine::Machine &right, const DiffOption &option);
+
+Outcome run(const turing::machine::Machine &machine, const std::string &input,
+            size_t maxSteps);
+
+} // namespace turing::batch
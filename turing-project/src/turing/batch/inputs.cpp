@@ -0,0 +1,94 @@
+#include "turing/batch/inputs.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "turing/util/number.hpp"
+
+namespace turing::batch {
+
+using turing::util::number::mix;
+
+ShortlexInputs::ShortlexInputs(std::vector<char> symbols, size_t maxLength)
+    : symbols_(std::move(symbols)), ranks_{}, size_(0) {
+  for (size_t i = 0; i < symbols_.size(); ++i) {
+    ranks_[static_cast<unsigned char>(symbols_[i])] =
+        static_cast<unsigned char>(i);
+  }
+
+  size_t count = 1;
+
+  for (size_t length = 0; length <= maxLength; ++length) {
+    if (size_ > std::numeric_limits<size_t>::max() - count) {
+      throw std::invalid_argument("input space too large");
+    }
+    size_ += count;
+    counts_.push_back(count);
+
+    if (symbols_.empty()) {
+      break;
+    }
+    if (length < maxLength &&
+        count > std::numeric_limits<size_t>::max() / symbols_.size()) {
+      throw std::invalid_argument("input space too large");
+    }
+    count *= symbols_.size();
+  }
+}
+
+size_t ShortlexInputs::size() const { return size_; }
+
+void ShortlexInputs::at(size_t index, std::string &input) const {
+  size_t length = 0;
+  while (index >= counts_[length]) {
+    index -= counts_[length];
+    ++length;
+  }
+
+  input.resize(length);
+  for (size_t i = length; i > 0; --i) {
+    input[i - 1] = symbols_[index % symbols_.size()];
+    index /= symbols_.size();
+  }
+}
+
+void ShortlexInputs::next(std::string &input) const {
+  if (symbols_.empty()) {
+    return;
+  }
+
+  // odometer increment, wrapping into a longer string of the first symbol
+  for (size_t i = input.size(); i > 0; --i) {
+    size_t rank = ranks_[static_cast<unsigned char>(input[i - 1])] + 1;
+    if (rank < symbols_.size()) {
+      input[i - 1] = symbols_[rank];
+      return;
+    }
+    input[i - 1] = symbols_[0];
+  }
+  input.push_back(symbols_[0]);
+}
+
+RandomInputs::RandomInputs(std::vector<char> symbols, size_t maxLength,
+                           size_t count, uint64_t seed)
+    : symbols_(std::move(symbols)), maxLength_(maxLength), count_(count),
+      seed_(seed) {}
+
+size_t RandomInputs::size() const { return count_; }
+
+void RandomInputs::at(size_t index, std::string &input) const {
+  uint64_t state = mix(seed_ ^ mix(index));
+
+  size_t length = symbols_.empty() ? 0 : state % (maxLength_ + 1);
+  input.resize(length);
+  for (size_t i = 0; i < length; ++i) {
+    state = mix(state);
+    input[i] = symbols_[state % symbols_.size()];
+  }
+}
+
+} // namespace turing::batch
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace turing::batch {
+
+// All strings over symbols of length at most maxLength in shortlex order
+// (by length, then lexicographically by the order of symbols), addressed by
+// index so that ranges of the space can be handed to different threads.
+class ShortlexInputs {
+public:
+  // throw std::invalid_argument if the space does not fit in size_t
+  ShortlexInputs(std::vector<char> symbols, size_t maxLength);
+
+  size_t size() const;
+  // write the index-th string into input, reusing its buffer
+  void at(size_t index, std::string &input) const;
+  // advance input to its successor in place, which is far cheaper than at()
+  // when walking a range
+  void next(std::string &input) const;
+
+private:
+  const std::vector<char> symbols_;
+  std::array<unsigned char, 256> ranks_; // position of a symbol in symbols_
+  std::vector<size_t> counts_; // counts_[n] strings have length n
+  size_t size_;
+};
+
+// count strings of length at most maxLength drawn uniformly by length, then
+// by symbol. The index-th string only depends on seed and index.
+class RandomInputs {
+public:
+  RandomInputs(std::vector<char> symbols, size_t maxLength, size_t count,
+               uint64_t seed);
+
+  size_t size() const;
+  void at(size_t index, std::string &input) const;
+
+private:
+  const std::vector<char> symbols_;
+  const size_t maxLength_;
+  const size_t count_;
+  const uint64_t seed_;
+};
+
+} // namespace turing::batch
@@ -0,0 +1,342 @@
+#include "turing/batch/processes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "turing/batch/inputs.h"
+#include "turing/batch/sweep.h"
+#include "turing/machine/compiled.hpp"
+#include "turing/machine/machine.h"
+#include "turing/util/ring.hpp"
+
+namespace turing::batch {
+
+namespace {
+// inputs handed to a worker at a time, and how many ranges it has queued
+constexpr size_t CHUNK = 1024;
+constexpr size_t QUEUED = 2;
+
+constexpr uint64_t NONE = std::numeric_limits<uint64_t>::max();
+
+enum Verdict : uint64_t { REJECTED = 0, ACCEPTED = 1, UNDECIDED = 2 };
+
+struct Range {
+  uint64_t begin;
+  uint64_t end;
+};
+
+// shared by the parent and the worker process of one slot
+struct Slot {
+  turing::util::Ring<Range, 4> work;
+  // index << 2 | verdict, in the order of the ranges in work
+  turing::util::Ring<uint64_t, 4096> results;
+  alignas(64) std::atomic<uint64_t> current; // input being run, or NONE
+  // bumped by the parent after it pushes work or sets done, for an idle
+  // worker to wait on
+  alignas(64) std::atomic<uint32_t> posted;
+};
+
+struct Shared {
+  alignas(64) std::atomic<bool> done; // no work is left, idle workers exit
+};
+
+// std::atomic::wait only wakes threads of one process, so idle workers wait
+// on a shared futex instead
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+void waitFor(std::atomic<uint32_t> &word, uint32_t seen) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, seen,
+            nullptr, nullptr, 0);
+}
+
+void post(std::atomic<uint32_t> &word) {
+  word.fetch_add(1, std::memory_order_release);
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, 1,
+            nullptr, nullptr, 0);
+}
+
+// Shared and the slots in an anonymous memfd mapping, inherited by fork
+class Region {
+public:
+  explicit Region(size_t nSlot)
+      : size_(sizeof(Shared) + nSlot * sizeof(Slot)), data_(nullptr) {
+    int fd = ::memfd_create("turing-sweep", MFD_CLOEXEC);
+    if (fd < 0) {
+      throw std::runtime_error(std::strerror(errno));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+      std::string message = std::strerror(errno);
+      ::close(fd);
+      throw std::runtime_error(message);
+    }
+    data_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+      throw std::runtime_error(std::strerror(errno));
+    }
+
+    new (data_) Shared{};
+    for (size_t i = 0; i < nSlot; ++i) {
+      new (&slot(i)) Slot{};
+    }
+  }
+
+  ~Region() { ::munmap(data_, size_); }
+
+  Region(const Region &) = delete;
+  Region &operator=(const Region &) = delete;
+
+  Shared &shared() { return *static_cast<Shared *>(data_); }
+  Slot &slot(size_t i) {
+    return reinterpret_cast<Slot *>(static_cast<char *>(data_) +
+                                    sizeof(Shared))[i];
+  }
+
+private:
+  size_t size_;
+  void *data_;
+};
+
+[[noreturn]] void work(const turing::machine::CompiledMachine &machine,
+                       const ShortlexInputs &inputs, size_t maxSteps,
+                       Shared &shared, Slot &slot) {
+  std::string input;
+  turing::machine::CompiledExecution execution{machine};
+
+  while (true) {
+    Range range;
+    uint32_t seen = slot.posted.load(std::memory_order_acquire);
+    if (!slot.work.pop(range)) {
+      if (shared.done.load(std::memory_order_acquire)) {
+        // skip the exit handlers and stdio buffers of the parent
+        ::_exit(0);
+      }
+      // returns at once if work or done was posted since seen was read
+      waitFor(slot.posted, seen);
+      continue;
+    }
+
+    inputs.at(range.begin, input);
+    for (uint64_t i = range.begin; i < range.end; ++i, inputs.next(input)) {
+      slot.current.store(i, std::memory_order_release);
+
+      execution.reset(input);
+      while (execution.steps() < maxSteps && execution.step()) {
+      }
+      uint64_t verdict = !execution.isHalted()   ? UNDECIDED
+                         : execution.isAccepted() ? ACCEPTED
+                                                  : REJECTED;
+
+      // the parent drains results when it polls
+      while (!slot.results.push(i << 2 | verdict)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+    slot.current.store(NONE, std::memory_order_release);
+  }
+}
+
+// parent side of a slot
+struct Worker {
+  pid_t pid;
+  std::deque<Range> assigned; // handed out and not reported yet, in order
+};
+
+} // namespace
+
+SweepReport sweepInProcesses(const turing::machine::Machine &machine,
+                             const SweepOption &option) {
+  std::vector<char> symbols{machine.inputAlphabet().begin(),
+                            machine.inputAlphabet().end()};
+  std::sort(symbols.begin(), symbols.end());
+  const ShortlexInputs inputs{symbols, option.maxLength};
+  const turing::machine::CompiledMachine compiled =
+      turing::machine::compile(machine, option.profile);
+
+  SweepReport report{
+      .inputs = inputs.size(),
+      .accepted = 0,
+      .undecided = 0,
+      .seconds = 0,
+      .accepts = std::vector<uint8_t>((inputs.size() + 7) / 8, 0),
+      .failed = {},
+  };
+
+  const size_t nWorker = std::max<size_t>(option.nThread, 1);
+  Region region{nWorker};
+  std::vector<Worker> workers(nWorker, Worker{.pid = -1, .assigned = {}});
+
+  uint64_t cursor = 0;        // inputs before it have been handed out once
+  std::deque<Range> retries;  // handed out again before the cursor moves on
+  std::unordered_set<uint64_t> crashed; // inputs that crashed a worker once
+  size_t reported = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  auto spawn = [&](size_t w) {
+    Slot &slot = region.slot(w);
+    slot.work.clear();
+    slot.results.clear();
+    slot.current.store(NONE);
+    slot.posted.store(0);
+
+    std::cout.flush();
+    pid_t pid = ::fork();
+    if (pid < 0) {
+      throw std::runtime_error(std::strerror(errno));
+    }
+    if (pid == 0) {
+      // an exception must not unwind into the parent's code: the parent
+      // sees the worker die and retries its input
+      try {
+        work(compiled, inputs, option.maxSteps, region.shared(), slot);
+      } catch (...) {
+        ::_exit(EXIT_FAILURE);
+      }
+    }
+    workers[w].pid = pid;
+  };
+
+  auto feed = [&](size_t w) {
+    Slot &slot = region.slot(w);
+    bool fed = false;
+    while (slot.work.size() < QUEUED) {
+      Range range;
+      if (!retries.empty()) {
+        range = retries.front();
+        retries.pop_front();
+      } else if (cursor < inputs.size()) {
+        range = {cursor, std::min<uint64_t>(cursor + CHUNK, inputs.size())};
+        cursor = range.end;
+      } else {
+        break;
+      }
+      slot.work.push(range);
+      workers[w].assigned.push_back(range);
+      fed = true;
+    }
+    if (fed) {
+      post(slot.posted);
+    }
+  };
+
+  auto collect = [&](size_t w) {
+    Slot &slot = region.slot(w);
+    std::deque<Range> &assigned = workers[w].assigned;
+    bool collected = false;
+
+    for (uint64_t result; slot.results.pop(result); collected = true) {
+      uint64_t i = result >> 2;
+      if ((result & 3) == UNDECIDED) {
+        ++report.undecided;
+      } else if ((result & 3) == ACCEPTED) {
+        ++report.accepted;
+        report.accepts[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+      }
+      ++reported;
+
+      if (++assigned.front().begin == assigned.front().end) {
+        assigned.pop_front();
+      }
+    }
+    return collected;
+  };
+
+  // the worker of slot w is gone: settle what it was given and replace it
+  auto recover = [&](size_t w) {
+    collect(w);
+    std::deque<Range> &assigned = workers[w].assigned;
+
+    if (!assigned.empty() &&
+        region.slot(w).current.load() == assigned.front().begin) {
+      uint64_t i = assigned.front().begin;
+      if (!crashed.insert(i).second) {
+        std::string input;
+        inputs.at(i, input);
+        report.failed.push_back(input);
+        ++reported;
+        if (++assigned.front().begin == assigned.front().end) {
+          assigned.pop_front();
+        }
+      }
+    }
+    retries.insert(retries.begin(), assigned.begin(), assigned.end());
+    assigned.clear();
+
+    spawn(w);
+  };
+
+  try {
+    for (size_t w = 0; w < nWorker; ++w) {
+      spawn(w);
+    }
+
+    while (reported < inputs.size()) {
+      bool progress = false;
+
+      for (size_t w = 0; w < nWorker; ++w) {
+        progress |= collect(w);
+        feed(w);
+
+        int status;
+        if (::waitpid(workers[w].pid, &status, WNOHANG) == workers[w].pid) {
+          recover(w);
+          progress = true;
+        }
+      }
+
+      if (!progress) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  } catch (...) {
+    for (const Worker &worker : workers) {
+      if (worker.pid > 0) {
+        ::kill(worker.pid, SIGKILL);
+      }
+    }
+    region.shared().done.store(true);
+    for (const Worker &worker : workers) {
+      if (worker.pid > 0) {
+        ::waitpid(worker.pid, nullptr, 0);
+      }
+    }
+    throw;
+  }
+
+  region.shared().done.store(true, std::memory_order_release);
+  for (size_t w = 0; w < nWorker; ++w) {
+    post(region.slot(w).posted);
+  }
+  for (const Worker &worker : workers) {
+    ::waitpid(worker.pid, nullptr, 0);
+  }
+
+  report.seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return report;
+}
+
+} // namespace turing::batch
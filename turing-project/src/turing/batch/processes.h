@@ -0,0 +1,17 @@
+#pragma once
+
+#include "turing/batch/sweep.h"
+#include "turing/machine/machine.h"
+
+namespace turing::batch {
+
+// sweep() in option.nThread worker processes forked from this one, which
+// share the parsed machine copy-on-write. The parent hands out ranges of
+// inputs and collects verdicts through lock-free rings in a memfd mapping,
+// so it always knows which input a worker was running. A worker that dies
+// is replaced; the input it was running is retried once, then reported in
+// SweepReport::failed. Throw std::runtime_error if workers cannot be set up.
+SweepReport sweepInProcesses(const turing::machine::Machine &machine,
+                             const SweepOption &option);
+
+} // namespace turing::batch
@@ -0,0 +1,128 @@
+#include "turing/batch/sweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "turing/batch/inputs.h"
+#include "turing/batch/processes.h"
+#include "turing/machine/compiled.hpp"
+#include "turing/machine/lockstep.h"
+#include "turing/machine/machine.h"
+
+namespace turing::batch {
+
+namespace {
+// inputs claimed by a worker at a time. A multiple of 8, so every byte of
+// the bitmap is written by a single worker.
+constexpr size_t CHUNK = 1024;
+static_assert(CHUNK % 8 == 0);
+
+// cells of every tape of a lockstep lane, enough for the heads of most runs
+// on inputs of maxLength to stay inside
+size_t windowFor(size_t maxLength) {
+  return std::bit_ceil(std::max<size_t>(64, 4 * (maxLength + 1)));
+}
+} // namespace
+
+SweepReport sweep(const turing::machine::Machine &machine,
+                  const SweepOption &option) {
+  if (option.processes) {
+    return sweepInProcesses(machine, option);
+  }
+
+  std::vector<char> symbols{machine.inputAlphabet().begin(),
+                            machine.inputAlphabet().end()};
+  std::sort(symbols.begin(), symbols.end());
+  const ShortlexInputs inputs{symbols, option.maxLength};
+
+  std::vector<uint8_t> accepts((inputs.size() + 7) / 8, 0);
+  std::atomic<size_t> next = 0;
+  std::atomic<size_t> accepted = 0;
+  std::atomic<size_t> undecided = 0;
+
+  const turing::machine::CompiledMachine compiled =
+      turing::machine::compile(machine, option.profile);
+
+  std::optional<turing::machine::LockstepTable> table;
+  if (option.lockstep && turing::machine::LockstepTable::fits(compiled)) {
+    table.emplace(compiled);
+  }
+
+  auto work = [&]() {
+    std::string input;
+    turing::machine::CompiledExecution execution{compiled};
+    std::optional<turing::machine::LockstepExecution> lockstep;
+    if (table.has_value()) {
+      lockstep.emplace(compiled, table.value(), windowFor(option.maxLength));
+    }
+    size_t localAccepted = 0;
+    size_t localUndecided = 0;
+
+    auto record = [&](size_t i, bool halted, bool isAccepted) {
+      if (!halted) {
+        ++localUndecided;
+      } else if (isAccepted) {
+        ++localAccepted;
+        accepts[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+      }
+    };
+
+    for (size_t begin = next.fetch_add(CHUNK); begin < inputs.size();
+         begin = next.fetch_add(CHUNK)) {
+      size_t end = std::min(begin + CHUNK, inputs.size());
+
+      inputs.at(begin, input);
+      if (lockstep.has_value()) {
+        lockstep->run(
+            end - begin, option.maxSteps,
+            [&](std::string &lane) {
+              lane = input;
+              inputs.next(input);
+            },
+            [&](size_t i, bool halted, bool isAccepted) {
+              record(begin + i, halted, isAccepted);
+            });
+        continue;
+      }
+
+      for (size_t i = begin; i < end; ++i, inputs.next(input)) {
+        execution.reset(input);
+        while (execution.steps() < option.maxSteps && execution.step()) {
+        }
+        record(i, execution.isHalted(), execution.isAccepted());
+      }
+    }
+
+    accepted += localAccepted;
+    undecided += localUndecided;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < std::max<size_t>(option.nThread, 1); ++i) {
+    workers.emplace_back(work);
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  return {
+      .inputs = inputs.size(),
+      .accepted = accepted,
+      .undecided = undecided,
+      .seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count(),
+      .accepts = std::move(accepts),
+  };
+}
+
+} // namespace turing::batch
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "turing/machine/machine.h"
+#include "turing/machine/profile.h"
+
+namespace turing::batch {
+
+struct SweepOption {
+  size_t maxLength; // longest input run
+  size_t maxSteps;  // per run, runs over budget are undecided
+  size_t nThread;
+  // run in nThread forked worker processes instead of threads, so that a
+  // crash only loses the input being run
+  bool processes = false;
+  // run every thread's inputs LockstepLanes::LANES at a time in lockstep,
+  // when the machine's LockstepTable fits. Not with processes.
+  bool lockstep = false;
+  // transition hits to lay the compiled machine out by
+  const turing::machine::Profile *profile = nullptr;
+};
+
+struct SweepReport {
+  size_t inputs;
+  size_t accepted;
+  size_t undecided; // runs that did not halt within maxSteps
+  double seconds;
+  // bit i (least significant first) is set when the i-th input in shortlex
+  // order is accepted. Undecided inputs are left unset.
+  std::vector<uint8_t> accepts;
+  // inputs that crashed their worker process twice
+  std::vector<std::string> failed;
+};
+
+// Run machine on every string over its input alphabet of length at most
+// maxLength, in shortlex order of the sorted alphabet.
+SweepReport sweep(const turing::machine::Machine &machine,
+                  const SweepOption &option);
+
+} // namespace turing::batch
@@ -0,0 +1,502 @@
+#include "turing/cache/result_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "turing/machine/observer.h"
+#include "turing/machine/transition.h"
+#include "turing/util/number.hpp"
+
+namespace turing::cache {
+
+namespace {
+constexpr uint64_t LOG_MAGIC = 0x3130474f4c4d54;    // "TMLOG01"
+constexpr uint64_t INDEX_MAGIC = 0x31305844494d54;  // "TMIDX01"
+constexpr uint64_t LOG_HEADER = 16;                 // magic, reserved
+constexpr uint64_t INITIAL_CAPACITY = 1024;
+// longer inputs or contents than this mark a damaged record
+constexpr uint64_t MAX_LENGTH = uint64_t{1} << 48;
+
+enum IndexWord : size_t { MAGIC, CAPACITY, COUNT, COVERED, HEADER_WORDS };
+
+// layout of a record in the log, followed by the input and the content,
+// padded to 8 bytes
+struct Record {
+  uint64_t high; // fingerprint of the machine
+  uint64_t low;
+  uint64_t key;
+  uint64_t steps;
+  uint64_t inputLength;
+  uint64_t contentLength;
+  uint64_t accepted;
+  uint64_t check; // of the fields above and the bytes after them
+};
+
+// a hash that does not change between builds, unlike std::hash
+uint64_t hash(std::string_view bytes, uint64_t seed) {
+  uint64_t h = turing::util::number::mix(seed ^ bytes.size());
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes.data() + i, sizeof(word));
+    h = turing::util::number::mix(h ^ word);
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+  return turing::util::number::mix(h ^ tail);
+}
+
+uint64_t keyOf(const Fingerprint &machine, std::string_view input) {
+  return hash(input, machine.high ^ turing::util::number::mix(machine.low));
+}
+
+uint64_t checksum(const Record &record, std::string_view payload) {
+  std::string_view fields{reinterpret_cast<const char *>(&record),
+                          offsetof(Record, check)};
+  return hash(payload, hash(fields, 0));
+}
+
+uint64_t padded(uint64_t length) { return (length + 7) & ~uint64_t{7}; }
+
+uint64_t sizeOf(const Record &record) {
+  return sizeof(Record) + padded(record.inputLength + record.contentLength);
+}
+
+template <typename T>
+std::vector<T> sorted(const std::unordered_set<T> &set) {
+  std::vector<T> items{set.begin(), set.end()};
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+// the machine as text that depends on nothing but what it does
+std::string normalized(const turing::machine::Machine &machine) {
+  std::string text = "Q";
+  for (const std::string &state : sorted(machine.states())) {
+    text += " " + state;
+  }
+  text += "\nS ";
+  for (char sign : sorted(machine.inputAlphabet())) {
+    text += sign;
+  }
+  text += "\nG ";
+  for (char sign : sorted(machine.tapeAlphabet())) {
+    text += sign;
+  }
+  text += "\nq0 " + machine.startState();
+  text += "\nB ";
+  text += machine.blankSymbol();
+  text += "\nF";
+  for (const std::string &state : sorted(machine.finalStates())) {
+    text += " " + state;
+  }
+  text += "\nN " + std::to_string(machine.nTape()) + "\n";
+
+  // the first transition that matches fires, so the order within a state
+  // is kept
+  std::vector<size_t> ids(machine.nTransition());
+  for (size_t id = 0; id < ids.size(); ++id) {
+    ids[id] = id;
+  }
+  std::stable_sort(ids.begin(), ids.end(), [&](size_t a, size_t b) {
+    return machine.transition(a).oldState < machine.transition(b).oldState;
+  });
+  for (size_t id : ids) {
+    text += turing::machine::statementOf(machine.transition(id)) + "\n";
+  }
+  return text;
+}
+
+// exclusive lock on a file for the lifetime of the object
+class Lock {
+public:
+  explicit Lock(int fd) : fd_(fd) {
+    while (::flock(fd_, LOCK_EX) != 0 && errno == EINTR) {
+    }
+  }
+  ~Lock() { ::flock(fd_, LOCK_UN); }
+
+  Lock(const Lock &) = delete;
+  Lock &operator=(const Lock &) = delete;
+
+private:
+  int fd_;
+};
+
+size_t fileSize(int fd) {
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+  return static_cast<size_t>(st.st_size);
+}
+
+void writeAll(int fd, const char *data, size_t length, uint64_t offset) {
+  while (length > 0) {
+    ssize_t n = ::pwrite(fd, data, length, static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw std::runtime_error(std::strerror(errno));
+    }
+    data += n;
+    length -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+} // namespace
+
+Fingerprint fingerprint(const turing::machine::Machine &machine) {
+  std::string text = normalized(machine);
+  return {
+      .high = hash(text, 0x243F6A8885A308D3ull),
+      .low = hash(text, 0x13198A2E03707344ull),
+  };
+}
+
+ResultCache::ResultCache(const std::string &directory)
+    : indexPath_((std::filesystem::path{directory} / "index").string()),
+      logFd_(-1), indexFd_(-1), log_(nullptr), logSize_(0), index_(nullptr),
+      indexSize_(0) {
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  std::string logPath = (std::filesystem::path{directory} / "log").string();
+  logFd_ = ::open(logPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (logFd_ < 0) {
+    throw std::invalid_argument("cannot open cache " + directory);
+  }
+
+  try {
+    Lock lock{logFd_};
+
+    uint64_t header[2] = {LOG_MAGIC, 0};
+    if (fileSize(logFd_) < LOG_HEADER) {
+      // a new log, or one whose creation was cut short
+      if (::ftruncate(logFd_, 0) != 0) {
+        throw std::runtime_error(std::strerror(errno));
+      }
+      writeAll(logFd_, reinterpret_cast<const char *>(header), LOG_HEADER, 0);
+    } else if (::pread(logFd_, header, sizeof(header), 0) !=
+                   sizeof(header) ||
+               header[0] != LOG_MAGIC) {
+      throw std::invalid_argument(directory + " is not a result cache");
+    }
+
+    indexFd_ = ::open(indexPath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (indexFd_ < 0) {
+      throw std::invalid_argument("cannot open cache " + directory);
+    }
+    mapIndex();
+    catchUp();
+  } catch (const std::runtime_error &e) {
+    release();
+    throw std::invalid_argument("cannot open cache " + directory + ": " +
+                                e.what());
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+ResultCache::~ResultCache() { release(); }
+
+void ResultCache::release() {
+  if (log_ != nullptr) {
+    ::munmap(const_cast<char *>(log_), logSize_);
+    log_ = nullptr;
+  }
+  if (index_ != nullptr) {
+    ::munmap(index_, indexSize_);
+    index_ = nullptr;
+  }
+  if (indexFd_ >= 0) {
+    ::close(indexFd_);
+    indexFd_ = -1;
+  }
+  if (logFd_ >= 0) {
+    ::close(logFd_);
+    logFd_ = -1;
+  }
+}
+
+std::optional<turing::machine::RunResult>
+ResultCache::find(const Fingerprint &machine, std::string_view input) {
+  uint64_t key = keyOf(machine, input);
+  uint64_t capacity = index_[CAPACITY];
+  uint64_t *slots = index_ + HEADER_WORDS;
+
+  // another process may be filling a slot: its offset is stored before
+  // its key, so a key that matches comes with its offset
+  for (uint64_t n = 0, i = key & (capacity - 1); n < capacity;
+       ++n, i = (i + 1) & (capacity - 1)) {
+    uint64_t slotKey =
+        std::atomic_ref{slots[2 * i]}.load(std::memory_order_acquire);
+    uint64_t offset =
+        std::atomic_ref{slots[2 * i + 1]}.load(std::memory_order_relaxed);
+    if (offset == 0) {
+      break;
+    }
+    if (slotKey != key) {
+      continue;
+    }
+
+    const char *found = this->record(offset);
+    if (found == nullptr) {
+      continue;
+    }
+    Record record;
+    std::memcpy(&record, found, sizeof(record));
+    const char *bytes = found + sizeof(Record);
+    if (record.high != machine.high || record.low != machine.low ||
+        record.key != key || record.inputLength != input.size() ||
+        std::memcmp(bytes, input.data(), input.size()) != 0) {
+      continue;
+    }
+    return turing::machine::RunResult{
+        .accepted = record.accepted != 0,
+        .steps = record.steps,
+        .content = std::string{bytes + record.inputLength,
+                               record.contentLength},
+    };
+  }
+  return std::nullopt;
+}
+
+void ResultCache::store(const Fingerprint &machine, std::string_view input,
+                        const turing::machine::RunResult &result) {
+  Lock lock{logFd_};
+  if (indexReplaced()) {
+    ::close(indexFd_);
+    indexFd_ = ::open(indexPath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (indexFd_ < 0) {
+      throw std::runtime_error(std::strerror(errno));
+    }
+    mapIndex();
+  }
+  catchUp();
+  if (find(machine, input).has_value()) {
+    return;
+  }
+
+  Record record{
+      .high = machine.high,
+      .low = machine.low,
+      .key = keyOf(machine, input),
+      .steps = result.steps,
+      .inputLength = input.size(),
+      .contentLength = result.content.size(),
+      .accepted = result.accepted,
+      .check = 0,
+  };
+  std::string bytes;
+  bytes.reserve(sizeOf(record));
+  bytes.append(sizeof(Record), '\0');
+  bytes.append(input);
+  bytes.append(result.content);
+  bytes.resize(sizeOf(record), '\0');
+  record.check = checksum(
+      record, std::string_view{bytes}.substr(
+                  sizeof(Record), record.inputLength + record.contentLength));
+  std::memcpy(bytes.data(), &record, sizeof(record));
+
+  // should the write be cut short, the next catchUp cuts the record off
+  uint64_t offset = index_[COVERED];
+  writeAll(logFd_, bytes.data(), bytes.size(), offset);
+  insert(record.key, offset);
+  index_[COVERED] = offset + bytes.size();
+}
+
+size_t ResultCache::size() const { return index_[COUNT]; }
+
+bool ResultCache::reach(uint64_t end) {
+  if (end <= logSize_) {
+    return true;
+  }
+  size_t size = fileSize(logFd_);
+  if (size < end) {
+    return false;
+  }
+
+  if (log_ != nullptr) {
+    ::munmap(const_cast<char *>(log_), logSize_);
+  }
+  void *data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, logFd_, 0);
+  if (data == MAP_FAILED) {
+    log_ = nullptr;
+    logSize_ = 0;
+    throw std::runtime_error(std::strerror(errno));
+  }
+  log_ = static_cast<const char *>(data);
+  logSize_ = size;
+  return true;
+}
+
+const char *ResultCache::record(uint64_t offset) {
+  if (offset < LOG_HEADER || offset % 8 != 0 ||
+      !reach(offset + sizeof(Record))) {
+    return nullptr;
+  }
+  Record record;
+  std::memcpy(&record, log_ + offset, sizeof(record));
+  if (record.inputLength > MAX_LENGTH || record.contentLength > MAX_LENGTH ||
+      !reach(offset + sizeOf(record))) {
+    return nullptr;
+  }
+
+  std::string_view payload{log_ + offset + sizeof(Record),
+                           record.inputLength + record.contentLength};
+  if (checksum(record, payload) != record.check) {
+    return nullptr;
+  }
+  return log_ + offset;
+}
+
+void ResultCache::mapIndex() {
+  if (index_ != nullptr) {
+    ::munmap(index_, indexSize_);
+    index_ = nullptr;
+  }
+
+  size_t size = fileSize(indexFd_);
+  if (size >= HEADER_WORDS * sizeof(uint64_t)) {
+    void *data =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, indexFd_, 0);
+    if (data != MAP_FAILED) {
+      index_ = static_cast<uint64_t *>(data);
+      indexSize_ = size;
+
+      uint64_t capacity = index_[CAPACITY];
+      if (index_[MAGIC] == INDEX_MAGIC && capacity > 0 &&
+          (capacity & (capacity - 1)) == 0 &&
+          size == (HEADER_WORDS + 2 * capacity) * sizeof(uint64_t) &&
+          index_[COVERED] >= LOG_HEADER) {
+        return;
+      }
+      ::munmap(index_, indexSize_);
+      index_ = nullptr;
+    }
+  }
+
+  // rebuilt by catchUp
+  reset(INITIAL_CAPACITY);
+}
+
+bool ResultCache::indexReplaced() const {
+  struct stat opened {};
+  struct stat named {};
+  if (::fstat(indexFd_, &opened) != 0 ||
+      ::stat(indexPath_.c_str(), &named) != 0) {
+    return true;
+  }
+  return opened.st_ino != named.st_ino || opened.st_dev != named.st_dev;
+}
+
+void ResultCache::catchUp() {
+  uint64_t end = fileSize(logFd_);
+  uint64_t offset = index_[COVERED];
+  if (offset > end) {
+    // the log lost records the index points to
+    reset(INITIAL_CAPACITY);
+    offset = LOG_HEADER;
+  }
+
+  while (offset < end) {
+    const char *found = this->record(offset);
+    if (found == nullptr) {
+      // a writer died in the middle of its record
+      if (::ftruncate(logFd_, static_cast<off_t>(offset)) != 0) {
+        throw std::runtime_error(std::strerror(errno));
+      }
+      break;
+    }
+    Record record;
+    std::memcpy(&record, found, sizeof(record));
+    insert(record.key, offset);
+    offset += sizeOf(record);
+  }
+  index_[COVERED] = offset;
+}
+
+void ResultCache::insert(uint64_t key, uint64_t offset) {
+  if ((index_[COUNT] + 1) * 2 > index_[CAPACITY]) {
+    grow();
+  }
+
+  uint64_t capacity = index_[CAPACITY];
+  uint64_t *slots = index_ + HEADER_WORDS;
+  uint64_t i = key & (capacity - 1);
+  while (slots[2 * i + 1] != 0) {
+    i = (i + 1) & (capacity - 1);
+  }
+  std::atomic_ref{slots[2 * i + 1]}.store(offset, std::memory_order_relaxed);
+  std::atomic_ref{slots[2 * i]}.store(key, std::memory_order_release);
+  ++index_[COUNT];
+}
+
+void ResultCache::reset(uint64_t capacity) {
+  // built aside and renamed over the index, so that other processes keep
+  // a whole index until they notice the new one
+  std::string path = indexPath_ + ".tmp";
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+  size_t size = (HEADER_WORDS + 2 * capacity) * sizeof(uint64_t);
+  void *data = MAP_FAILED;
+  if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (data == MAP_FAILED || ::rename(path.c_str(), indexPath_.c_str()) != 0) {
+    std::string message = std::strerror(errno);
+    if (data != MAP_FAILED) {
+      ::munmap(data, size);
+    }
+    ::close(fd);
+    throw std::runtime_error(message);
+  }
+
+  if (index_ != nullptr) {
+    ::munmap(index_, indexSize_);
+  }
+  ::close(indexFd_);
+  indexFd_ = fd;
+  index_ = static_cast<uint64_t *>(data);
+  indexSize_ = size;
+  index_[CAPACITY] = capacity;
+  index_[COUNT] = 0;
+  index_[COVERED] = LOG_HEADER;
+  index_[MAGIC] = INDEX_MAGIC;
+}
+
+void ResultCache::grow() {
+  uint64_t capacity = index_[CAPACITY];
+  uint64_t covered = index_[COVERED];
+  std::vector<uint64_t> slots(index_ + HEADER_WORDS,
+                              index_ + HEADER_WORDS + 2 * capacity);
+
+  reset(capacity * 2);
+  for (size_t i = 0; i < capacity; ++i) {
+    if (slots[2 * i + 1] != 0) {
+      insert(slots[2 * i], slots[2 * i + 1]);
+    }
+  }
+  index_[COVERED] = covered;
+}
+
+} // namespace turing::cache
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "turing/machine/machine.h"
+
+namespace turing::cache {
+
+// 128-bit content hash of a machine, the same across runs and builds. It
+// covers the normalized machine: sets are hashed sorted and transitions are
+// grouped by state, each state keeping the order of its transitions, so
+// reordering the declarations or reformatting the file keeps the hash while
+// any change to what the machine does changes it.
+struct Fingerprint {
+  uint64_t high;
+  uint64_t low;
+
+  bool operator==(const Fingerprint &) const = default;
+};
+
+Fingerprint fingerprint(const turing::machine::Machine &machine);
+
+// Results of halted runs kept on disk across processes, keyed by the
+// fingerprint of the machine and the input.
+//
+// <directory>/log is an append-only sequence of records holding the key,
+// the result and a checksum, followed by the input and the content. Every
+// hit compares the whole input, so a hash collision is only a miss.
+// <directory>/index is an open-addressing table from key hashes to record
+// offsets, both memory-mapped. The index notes how much of the log it
+// covers and catches up on the records other processes appended; it is
+// rebuilt from the log when missing or damaged, and a torn record at the
+// end of the log is cut off.
+//
+// Writers serialize on a lock of the log; lookups take no lock.
+class ResultCache {
+public:
+  // create directory and its files as needed, throw std::invalid_argument
+  // when they cannot be opened
+  explicit ResultCache(const std::string &directory);
+  ~ResultCache();
+
+  ResultCache(const ResultCache &) = delete;
+  ResultCache &operator=(const ResultCache &) = delete;
+
+  std::optional<turing::machine::RunResult> find(const Fingerprint &machine,
+                                                 std::string_view input);
+  // keep result unless an equal key is already stored
+  void store(const Fingerprint &machine, std::string_view input,
+             const turing::machine::RunResult &result);
+
+  size_t size() const; // records indexed
+
+private:
+  std::string indexPath_;
+  int logFd_;
+  int indexFd_;
+
+  const char *log_; // mapping of the first logSize_ bytes of the log
+  size_t logSize_;
+  uint64_t *index_; // header words, then (key, offset) slots
+  size_t indexSize_;
+
+  void release();
+  // record at offset of the mapped log, verified, or nullptr
+  const char *record(uint64_t offset);
+  // map the log up to at least end, return false if it is shorter
+  bool reach(uint64_t end);
+  void mapIndex();
+  // the index file was replaced by a larger one since it was mapped
+  bool indexReplaced() const;
+  // index the records appended after those the index covers, cutting off
+  // a torn one at the end
+  void catchUp();
+  void insert(uint64_t key, uint64_t offset);
+  // replace the index by an empty one with capacity slots
+  void reset(uint64_t capacity);
+  void grow();
+};
+
+} // namespace turing::cache
@@ -1,25 +1,97 @@
 #include "turing/cli/cli.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <exception>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <variant>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "turing/batch/diff.h"
+#include "turing/batch/sweep.h"
+#include "turing/cache/result_cache.h"
 #include "turing/cli/exception.h"
 #include "turing/cli/option.h"
+#include "turing/debug/debugger.h"
+#include "turing/gen/workload.h"
 #include "turing/log/log.hpp"
 #include "turing/machine/exception.h"
 #include "turing/machine/machine.h"
+#include "turing/machine/profile.h"
 #include "turing/parser/parser.hpp"
+#include "turing/server/server.h"
+#include "turing/util/file.h"
+#include "turing/util/string.h"
 
 namespace turing::cli {
 
+namespace {
+// remove "flag value" from args and return value
+std::optional<std::string> takeFlag(std::vector<std::string> &args,
+                                    const std::string &flag) {
+  auto it = std::find(args.begin(), args.end(), flag);
+  if (it == args.end()) {
+    return std::nullopt;
+  }
+  if (std::next(it) == args.end()) {
+    throw std::invalid_argument("illegal args");
+  }
+
+  std::string value = *std::next(it);
+  args.erase(it, std::next(it, 2));
+  return value;
+}
+
+size_t takeNumber(std::vector<std::string> &args, const std::string &flag,
+                  size_t fallback) {
+  std::optional<std::string> value = takeFlag(args, flag);
+  if (!value.has_value()) {
+    return fallback;
+  }
+
+  size_t number = turing::util::string::to_size_t(value.value());
+  if (number == std::numeric_limits<size_t>::max()) {
+    throw std::invalid_argument("illegal args");
+  }
+  return number;
+}
+} // namespace
+
 Option parseArgs(int argc, const char **argv) {
   static const std::string ILLEGAL_ARGS_MESSAGE = "illegal args";
   static const std::string HELP_MESSAGE =
-      "usage: turing [-v|--verbose] [-h|--help] <tm> <input>";
+      "usage: turing [-v|--verbose] [-h|--help] [--detect-loops] [--decide] "
+      "[trace] <tm> <input>\n"
+      "       turing [-v|--verbose] [--detect-loops] [--decide] [trace] "
+      "--input-file <file> <tm>\n"
+      "       turing [-v|--verbose] [--decide] [trace] --input-stream <file|-> "
+      "<tm>\n"
+      "       turing --serve <socket> [--watch]\n"
+      "       turing diff [--length <n>] [--random <count>] [--seed <seed>]\n"
+      "                   [--max-steps <n>] <tm> <tm>\n"
+      "       turing sweep [--length <n>] [--max-steps <n>] [--output <file>]\n"
+      "                    [--workers <n>] [--processes | --lockstep]\n"
+      "                    [--profile-use <file>] <tm>\n"
+      "       turing debug <tm> <input>\n"
+      "       turing gen [--size <n>] [--tapes <n>] [--seed <seed>] <kind> "
+      "<prefix>\n"
+      "trace: [--trace-every <n>] [--trace-states <state,...>] "
+      "[--trace-tape <tape>]\n"
+      "       [--trace-last <n>] [--trace-file <file>] [--profile <file>]\n"
+      "       [--profile-use <file>] [--cache <dir>]";
 
   if (argc == 1) {
     throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
@@ -41,14 +113,129 @@ Option parseArgs(int argc, const char **argv) {
     };
   }
 
+  if (auto it = std::find(args.begin(), args.end(), "--serve");
+      it != args.end()) {
+    if (std::next(it) == args.end()) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    return ServeOption{
+        .socket = *std::next(it),
+        .watch = std::find(args.begin(), args.end(), "--watch") != args.end(),
+    };
+  }
+
+  if (args[0] == "diff") {
+    args.erase(args.begin());
+    DiffOption diffOption{
+        .maxLength = takeNumber(args, "--length", 8),
+        .randomInputs = takeNumber(args, "--random", 0),
+        .seed = takeNumber(args, "--seed", 0),
+        .maxSteps = takeNumber(args, "--max-steps", 100000),
+    };
+    if (args.size() != 2) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    diffOption.left = args[0];
+    diffOption.right = args[1];
+    return diffOption;
+  }
+
+  if (args[0] == "sweep") {
+    args.erase(args.begin());
+    SweepOption sweepOption{
+        .maxLength = takeNumber(args, "--length", 8),
+        .maxSteps = takeNumber(args, "--max-steps", 100000),
+        .output = takeFlag(args, "--output"),
+        .workers = takeNumber(args, "--workers",
+                              std::max(1u, std::thread::hardware_concurrency())),
+        .processes = false,
+        .lockstep = false,
+        .profileUse = takeFlag(args, "--profile-use"),
+    };
+    if (auto it = std::find(args.begin(), args.end(), "--processes");
+        it != args.end()) {
+      sweepOption.processes = true;
+      args.erase(it);
+    }
+    if (auto it = std::find(args.begin(), args.end(), "--lockstep");
+        it != args.end()) {
+      sweepOption.lockstep = true;
+      args.erase(it);
+    }
+    if (sweepOption.processes && sweepOption.lockstep) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    if (args.size() != 1) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    sweepOption.tm = args[0];
+    return sweepOption;
+  }
+
+  if (args[0] == "gen") {
+    args.erase(args.begin());
+    GenOption genOption{
+        .size = takeNumber(args, "--size", 16),
+        .nTape = takeNumber(args, "--tapes", 4),
+        .seed = takeNumber(args, "--seed", 0),
+    };
+    if (args.size() != 2) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    genOption.kind = args[0];
+    genOption.prefix = args[1];
+    return genOption;
+  }
+
+  if (args[0] == "debug") {
+    if (args.size() != 3) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    return DebugOption{
+        .tm = args[1],
+        .input = args[2],
+    };
+  }
+
   if (args.size() < 2) {
     throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
   }
 
   RunOption runOption = {
       .verbose = false,
+      .detectLoops = false,
   };
 
+  if (auto it = std::find(args.begin(), args.end(), "--detect-loops");
+      it != args.end()) {
+    runOption.detectLoops = true;
+    args.erase(it);
+  }
+  if (auto it = std::find(args.begin(), args.end(), "--decide");
+      it != args.end()) {
+    runOption.observe.decide = true;
+    args.erase(it);
+  }
+
+  // trace filters imply a verbose run
+  runOption.trace.every = takeNumber(args, "--trace-every", 1);
+  runOption.trace.last = takeNumber(args, "--trace-last", 0);
+  if (auto tape = takeNumber(args, "--trace-tape", SIZE_MAX); tape != SIZE_MAX) {
+    runOption.trace.tape = tape;
+  }
+  if (auto states = takeFlag(args, "--trace-states"); states.has_value()) {
+    std::istringstream stream{states.value()};
+    for (std::string state; std::getline(stream, state, ',');) {
+      runOption.trace.states.push_back(state);
+    }
+  }
+  bool traced = runOption.trace != turing::machine::TraceOption{};
+  // the observers that write files do not print anything
+  runOption.observe.traceFile = takeFlag(args, "--trace-file");
+  runOption.observe.profile = takeFlag(args, "--profile");
+  runOption.profileUse = takeFlag(args, "--profile-use");
+  runOption.cache = takeFlag(args, "--cache");
+
   if (std::find(args.begin(), args.end(), "-v") != args.end() ||
       std::find(args.begin(), args.end(), "--verbose") != args.end()) {
     runOption.verbose = true;
@@ -57,12 +244,103 @@ Option parseArgs(int argc, const char **argv) {
     }
   }
 
+  static const std::vector<
+      std::pair<std::string, std::optional<std::string> RunOption::*>>
+      INPUT_FLAGS = {
+          {"--input-file", &RunOption::inputFile},
+          {"--input-stream", &RunOption::inputStream},
+      };
+
+  for (const auto &[flag, member] : INPUT_FLAGS) {
+    auto it = std::find(args.begin(), args.end(), flag);
+    if (it == args.end()) {
+      continue;
+    }
+    if (std::next(it) == args.end()) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    runOption.*member = *std::next(it);
+    args.erase(it, std::next(it, 2));
+    // loops are found by hashing the whole tape, which a stream never holds
+    if (runOption.detectLoops && runOption.inputStream.has_value()) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    // nor can it be a cache key
+    if (runOption.cache.has_value() && runOption.inputStream.has_value()) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    if (args.size() < (runOption.verbose ? 2 : 1)) {
+      throw std::invalid_argument(ILLEGAL_ARGS_MESSAGE);
+    }
+    runOption.tm = args[args.size() - 1];
+    runOption.verbose |= traced;
+    return runOption;
+  }
+
   runOption.tm = args[args.size() - 2];
   runOption.input = args[args.size() - 1];
+  runOption.verbose |= traced;
 
   return runOption;
 }
 
+namespace {
+// the input file may end with a newline, which is not part of the input
+std::string_view inputOf(const turing::util::file::MappedFile &file) {
+  std::string_view input = file.view();
+  if (input.ends_with('\n')) {
+    input.remove_suffix(1);
+    if (input.ends_with('\r')) {
+      input.remove_suffix(1);
+    }
+  }
+  return input;
+}
+
+void runStream(const turing::machine::Machine &tm, const std::string &path,
+               const turing::machine::TraceOption &trace,
+               const turing::machine::ObserveOption &observe) {
+  static const std::string STDIN = "-";
+
+  int fd = path == STDIN ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    turing::log::error("invalid filepath");
+    throw turing::cli::CliException(std::runtime_error("invalid filepath"));
+  }
+
+  try {
+    tm.runStream(fd, trace, observe);
+  } catch (...) {
+    if (fd != STDIN_FILENO) {
+      ::close(fd);
+    }
+    throw;
+  }
+
+  if (fd != STDIN_FILENO) {
+    ::close(fd);
+  }
+}
+
+// parse tm, with its transitions ordered by the profile at profileUse if
+// given
+turing::machine::Machine load(const std::string &tm,
+                              const std::optional<std::string> &profileUse) {
+  turing::machine::Machine machine = turing::parser::parse(tm);
+  if (!profileUse.has_value()) {
+    return machine;
+  }
+
+  try {
+    turing::machine::Profile profile{machine, profileUse.value()};
+    return turing::machine::reorder(machine, profile);
+  } catch (const std::invalid_argument &e) {
+    turing::log::error(e.what());
+    throw turing::cli::CliException(std::runtime_error(e.what()));
+  }
+}
+} // namespace
+
 class CliVisitor {
 public:
   void operator()(const HelpOption &option) {
@@ -74,12 +352,218 @@ public:
       turing::log::verbose();
     }
 
-    turing::machine::Machine tm = turing::parser::parse(option.tm);
+    const turing::machine::Machine tm = load(option.tm, option.profileUse);
 
     try {
-      tm.run(option.input);
+      turing::machine::TraceFilter{tm, option.trace};
+    } catch (const std::invalid_argument &e) {
+      turing::log::error(e.what());
+      throw turing::cli::CliException(std::runtime_error(e.what()));
+    }
+
+    try {
+      if (option.inputStream.has_value()) {
+        runStream(tm, option.inputStream.value(), option.trace,
+                  option.observe);
+        return;
+      }
+
+      std::optional<turing::util::file::MappedFile> file;
+      if (option.inputFile.has_value()) {
+        try {
+          file.emplace(option.inputFile.value());
+        } catch (const std::invalid_argument &e) {
+          turing::log::error(e.what());
+          throw turing::cli::CliException(std::runtime_error(e.what()));
+        }
+      }
+      std::string_view input =
+          file.has_value() ? inputOf(file.value()) : option.input;
+
+      // verbose runs, profiles and trace files need the steps themselves,
+      // and a run that only decides has no result to keep
+      std::optional<turing::cache::ResultCache> cache;
+      if (option.cache.has_value() && !option.verbose &&
+          !option.observe.profile.has_value() &&
+          !option.observe.traceFile.has_value() && !option.observe.decide) {
+        try {
+          cache.emplace(option.cache.value());
+        } catch (const std::invalid_argument &e) {
+          turing::log::error(e.what());
+          throw turing::cli::CliException(std::runtime_error(e.what()));
+        }
+      }
+
+      turing::cache::Fingerprint machine{};
+      if (cache.has_value()) {
+        machine = turing::cache::fingerprint(tm);
+        if (auto hit = cache->find(machine, input); hit.has_value()) {
+          turing::log::info(hit->accepted ? "(ACCEPTED) " : "(UNACCEPTED) ",
+                            hit->content);
+          return;
+        }
+      }
+
+      // only a result that is stored needs a copy of its content
+      auto result = tm.run(input, option.detectLoops, option.trace,
+                           option.observe, cache.has_value());
+
+      if (cache.has_value() && result.has_value()) {
+        try {
+          cache->store(machine, input, result.value());
+        } catch (const std::runtime_error &e) {
+          // the result is printed already, only later runs miss it
+          turing::log::error("cache: ", e.what());
+        }
+      }
     } catch (const turing::machine::InvalidInputException &e) {
       throw turing::cli::CliException(e);
+    } catch (const std::invalid_argument &e) {
+      // an observer could not write its file
+      turing::log::error(e.what());
+      throw turing::cli::CliException(std::runtime_error(e.what()));
+    }
+  }
+
+  void operator()(const DiffOption &option) {
+    const turing::machine::Machine left = turing::parser::parse(option.left);
+    const turing::machine::Machine right = turing::parser::parse(option.right);
+
+    turing::batch::DiffReport report;
+    try {
+      report = turing::batch::diff(
+          left, right,
+          {
+              .maxLength = option.maxLength,
+              .randomInputs = option.randomInputs,
+              .seed = option.seed,
+              .maxSteps = option.maxSteps,
+              .nThread = std::max(1u, std::thread::hardware_concurrency()),
+          });
+    } catch (const std::invalid_argument &e) {
+      turing::log::error(e.what());
+      throw turing::cli::CliException(std::runtime_error(e.what()));
+    }
+
+    size_t runs = report.checked + report.undecided;
+    if (!report.input.has_value()) {
+      turing::log::info("(EQUIVALENT) ", report.checked, " inputs, ",
+                        report.undecided, " undecided, ",
+                        static_cast<size_t>(runs / std::max(report.seconds, 1e-9)),
+                        " inputs/s");
+      return;
+    }
+
+    static auto describe = [](const turing::batch::Outcome &outcome) {
+      return std::string{outcome.accepted ? "(ACCEPTED) " : "(UNACCEPTED) "} +
+             outcome.content;
+    };
+    turing::log::info("(DIFFERENT) \"", report.input.value(), "\"");
+    turing::log::info(option.left, ": ", describe(report.left));
+    turing::log::info(option.right, ": ", describe(report.right));
+    throw turing::cli::CliException(std::runtime_error("machines differ"));
+  }
+
+  void operator()(const SweepOption &option) {
+    const turing::machine::Machine machine = turing::parser::parse(option.tm);
+
+    std::optional<turing::machine::Profile> profile;
+    if (option.profileUse.has_value()) {
+      try {
+        profile.emplace(machine, option.profileUse.value());
+      } catch (const std::invalid_argument &e) {
+        turing::log::error(e.what());
+        throw turing::cli::CliException(std::runtime_error(e.what()));
+      }
+    }
+
+    turing::batch::SweepReport report;
+    try {
+      report = turing::batch::sweep(
+          machine, {
+                       .maxLength = option.maxLength,
+                       .maxSteps = option.maxSteps,
+                       .nThread = option.workers,
+                       .processes = option.processes,
+                       .lockstep = option.lockstep,
+                       .profile = profile.has_value() ? &profile.value()
+                                                      : nullptr,
+                   });
+    } catch (const std::invalid_argument &e) {
+      turing::log::error(e.what());
+      throw turing::cli::CliException(std::runtime_error(e.what()));
+    } catch (const std::runtime_error &e) {
+      turing::log::error("sweep: ", e.what());
+      throw turing::cli::CliException(e);
+    }
+
+    if (option.output.has_value()) {
+      std::ofstream out{option.output.value(), std::ios::binary};
+      out.write(reinterpret_cast<const char *>(report.accepts.data()),
+                static_cast<std::streamsize>(report.accepts.size()));
+      if (!out) {
+        turing::log::error("cannot write ", option.output.value());
+        throw turing::cli::CliException(std::runtime_error("write failed"));
+      }
+    }
+
+    for (const std::string &input : report.failed) {
+      turing::log::error("worker crashed on \"", input, "\"");
+    }
+
+    turing::log::info("(SWEPT) ", report.inputs, " inputs, ", report.accepted,
+                      " accepted, ", report.undecided, " undecided, ",
+                      static_cast<size_t>(report.inputs /
+                                          std::max(report.seconds, 1e-9)),
+                      " inputs/s");
+  }
+
+  void operator()(const DebugOption &option) {
+    const turing::machine::Machine tm = turing::parser::parse(option.tm);
+
+    if (std::holds_alternative<size_t>(tm.isInputValid(option.input))) {
+      turing::log::error("illegal input string");
+      throw turing::cli::CliException(
+          turing::machine::InvalidInputException(option.input));
+    }
+
+    turing::debug::Debugger debugger{tm, option.input};
+    debugger.repl(std::cin, std::cout);
+  }
+
+  void operator()(const GenOption &option) {
+    std::ofstream tm{option.prefix + ".tm"};
+    std::ofstream input{option.prefix + ".in"};
+    if (!tm || !input) {
+      turing::log::error("cannot write ", option.prefix);
+      throw turing::cli::CliException(std::runtime_error("write failed"));
+    }
+
+    try {
+      turing::gen::generate(option.kind,
+                            {
+                                .size = option.size,
+                                .nTape = option.nTape,
+                                .seed = option.seed,
+                            },
+                            tm, input);
+    } catch (const std::invalid_argument &e) {
+      turing::log::error(e.what());
+      throw turing::cli::CliException(std::runtime_error(e.what()));
+    }
+    input << "\n";
+  }
+
+  void operator()(const ServeOption &option) {
+    static const size_t CACHE_CAPACITY = 64;
+
+    turing::server::Server server{option.socket, CACHE_CAPACITY, option.watch};
+
+    try {
+      server.serve();
+    } catch (const std::runtime_error &e) {
+      turing::log::error("serve: ", e.what());
+      throw turing::cli::CliException(e);
     }
   }
 };
@@ -1,18 +1,69 @@
 #pragma once
 
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <variant>
 
+#include "turing/machine/observer.h"
+#include "turing/machine/trace.h"
+
 namespace turing::cli {
 struct RunOption {
   bool verbose;
+  bool detectLoops;
+  std::string tm;
+  std::string input;
+  std::optional<std::string> inputFile;
+  std::optional<std::string> inputStream;
+  turing::machine::TraceOption trace;
+  turing::machine::ObserveOption observe;
+  std::optional<std::string> profileUse; // written by --profile
+  std::optional<std::string> cache;      // directory of a ResultCache
+};
+
+struct ServeOption {
+  std::string socket;
+  bool watch; // reload machine files as soon as they change
+};
+
+struct DiffOption {
+  std::string left;
+  std::string right;
+  size_t maxLength;
+  size_t randomInputs;
+  size_t seed;
+  size_t maxSteps;
+};
+
+struct SweepOption {
+  std::string tm;
+  size_t maxLength;
+  size_t maxSteps;
+  std::optional<std::string> output;
+  size_t workers;
+  bool processes; // workers are processes instead of threads
+  bool lockstep;  // workers run their inputs in SIMD lanes
+  std::optional<std::string> profileUse;
+};
+
+struct DebugOption {
   std::string tm;
   std::string input;
 };
 
+struct GenOption {
+  std::string kind;
+  std::string prefix;
+  size_t size;
+  size_t nTape;
+  size_t seed;
+};
+
 struct HelpOption {
   std::string message;
 };
 
-using Option = std::variant<RunOption, HelpOption>;
+using Option = std::variant<RunOption, ServeOption, DiffOption, SweepOption,
+                            DebugOption, GenOption, HelpOption>;
 } // namespace turing::cli
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "turing/debug/breakpoint.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+#include "turing/util/string.h"
+
+namespace turing::debug {
+
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::Transition;
+
+namespace {
+std::string signsOf(const Transition &transition) {
+  return {transition.oldSigns.begin(), transition.oldSigns.end()};
+}
+
+// whether the pattern of transition can match signs
+bool mayRead(const Transition &transition, const std::string &signs) {
+  for (size_t i = 0; i < signs.size(); ++i) {
+    char sign = transition.oldSigns[i];
+    if (sign != signs[i] && sign != turing::util::string::STAR) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+Breakpoints::Breakpoints(const Machine &machine)
+    : machine_(machine), flags_(machine.nTransition(), 0),
+      signs_(machine.nTape(), '\0') {}
+
+void Breakpoints::onState(const std::string &state) {
+  if (!machine_.states().contains(state)) {
+    throw std::invalid_argument("unknown state " + state);
+  }
+
+  // staying in state through a self loop does not enter it again
+  for (size_t id = 0; id < machine_.nTransition(); ++id) {
+    const Transition &transition = machine_.transition(id);
+    if (transition.newState == state && transition.oldState != state) {
+      flags_[id] |= ENTER;
+    }
+  }
+  descriptions_.push_back("state " + state);
+}
+
+void Breakpoints::onRead(const std::string &signs) {
+  if (signs.size() != machine_.nTape()) {
+    throw std::invalid_argument("expect one symbol per tape");
+  }
+
+  for (size_t id = 0; id < machine_.nTransition(); ++id) {
+    if (mayRead(machine_.transition(id), signs)) {
+      flags_[id] |= READ;
+    }
+  }
+  reads_.push_back(signs);
+  descriptions_.push_back("read " + signs);
+}
+
+void Breakpoints::onFire(const std::string &state, const std::string &signs) {
+  bool found = false;
+  for (size_t id = 0; id < machine_.nTransition(); ++id) {
+    const Transition &transition = machine_.transition(id);
+    if (transition.oldState == state && signsOf(transition) == signs) {
+      flags_[id] |= FIRE;
+      found = true;
+    }
+  }
+  if (!found) {
+    throw std::invalid_argument("no transition " + state + " " + signs);
+  }
+  descriptions_.push_back("fire " + state + " " + signs);
+}
+
+void Breakpoints::onHead(size_t tape, int64_t index) {
+  if (tape >= machine_.nTape()) {
+    throw std::invalid_argument("no tape " + std::to_string(tape));
+  }
+  heads_.emplace_back(tape, index);
+  descriptions_.push_back("head " + std::to_string(tape) + " " +
+                          std::to_string(index));
+}
+
+void Breakpoints::onStep(size_t step) {
+  steps_.push_back(step);
+  descriptions_.push_back("step " + std::to_string(step));
+}
+
+void Breakpoints::clear() {
+  std::fill(flags_.begin(), flags_.end(), 0);
+  reads_.clear();
+  heads_.clear();
+  steps_.clear();
+  descriptions_.clear();
+}
+
+const std::vector<std::string> &Breakpoints::descriptions() const {
+  return descriptions_;
+}
+
+std::optional<std::string> Breakpoints::check(const Transition &fired,
+                                              const Execution &execution) const {
+  const turing::machine::Tapes &tapes = execution.tapes();
+
+  if (flags_[fired.id] & ENTER) {
+    return "state " + fired.newState;
+  }
+
+  if (const Transition *next = execution.next(); next != nullptr) {
+    uint8_t flags = flags_[next->id];
+    if (flags & FIRE) {
+      return "fire " + next->oldState + " " + signsOf(*next);
+    }
+    if (flags & READ) {
+      tapes.currentSigns(signs_.data());
+      if (std::find(reads_.begin(), reads_.end(), signs_) != reads_.end()) {
+        return "read " + signs_;
+      }
+    }
+  }
+
+  for (const auto &[tape, index] : heads_) {
+    if (tapes.head(tape) == index) {
+      return "head " + std::to_string(tape) + " " + std::to_string(index);
+    }
+  }
+
+  for (size_t step : steps_) {
+    if (tapes.steps() == step) {
+      return "step " + std::to_string(step);
+    }
+  }
+
+  return std::nullopt;
+}
+
+} // namespace turing::debug
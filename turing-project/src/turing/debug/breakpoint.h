@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+
+namespace turing::debug {
+
+// Breakpoints compiled against the transition ids of one machine. State and
+// transition conditions become a flag byte per transition, so a step that
+// hits nothing costs two table lookups plus one compare per head and step
+// breakpoint, and no string is touched.
+class Breakpoints {
+public:
+  explicit Breakpoints(const turing::machine::Machine &machine);
+
+  // each throws std::invalid_argument when the condition can never hold
+  void onState(const std::string &state);            // state is entered
+  void onRead(const std::string &signs);             // heads read signs
+  void onFire(const std::string &state,
+              const std::string &signs);              // transition fires next
+  void onHead(size_t tape, int64_t index);           // head reaches index
+  void onStep(size_t step);                          // step is reached
+
+  void clear();
+  const std::vector<std::string> &descriptions() const;
+
+  // Why execution stops after it stepped with fired, if it does. Read and
+  // fire conditions look at the step about to happen.
+  std::optional<std::string>
+  check(const turing::machine::Transition &fired,
+        const turing::machine::Execution &execution) const;
+
+private:
+  static constexpr uint8_t ENTER = 1;
+  static constexpr uint8_t FIRE = 2;
+  static constexpr uint8_t READ = 4; // some armed tuple may match
+
+  const turing::machine::Machine &machine_;
+  std::vector<uint8_t> flags_; // by transition id
+  std::vector<std::string> reads_;
+  std::vector<std::pair<size_t, int64_t>> heads_;
+  std::vector<size_t> steps_;
+  std::vector<std::string> descriptions_;
+  mutable std::string signs_; // scratch for the symbols under the heads
+};
+
+// Observer stopping a run at the first breakpoint hit, see
+// turing/machine/observer.h
+class BreakpointObserver {
+public:
+  explicit BreakpointObserver(const Breakpoints &breakpoints)
+      : breakpoints_(breakpoints) {}
+
+  void before(const turing::machine::Transition &,
+              const turing::machine::Tapes &) {}
+  bool after(const turing::machine::Transition &fired,
+             const turing::machine::Execution &execution) {
+    reason_ = breakpoints_.check(fired, execution);
+    return reason_.has_value();
+  }
+
+  // the breakpoint hit, if any
+  const std::optional<std::string> &reason() const { return reason_; }
+
+private:
+  const Breakpoints &breakpoints_;
+  std::optional<std::string> reason_;
+};
+
+} // namespace turing::debug
@@ -0,0 +1,167 @@
+#include "turing/debug/debugger.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turing/debug/breakpoint.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/observer.h"
+#include "turing/machine/transition.h"
+
+namespace turing::debug {
+
+namespace {
+const std::string PROMPT = "(turing) ";
+
+const std::string HELP =
+    "break state <state>          stop once state is entered\n"
+    "break read <symbols>         stop when the heads read symbols\n"
+    "break fire <state> <symbols> stop before that transition fires\n"
+    "break head <tape> <index>    stop when the head of tape reaches index\n"
+    "break step <n>               stop at step n\n"
+    "info                         list breakpoints\n"
+    "delete                       remove all breakpoints\n"
+    "continue|c                   run until a breakpoint or halt\n"
+    "step|s [n]                   go n steps forward\n"
+    "back|b [n]                   go n steps backward\n"
+    "goto <n>                     go to step n\n"
+    "print|p                      print the configuration\n"
+    "quit|q                       leave";
+
+size_t toSize(const std::string &word) {
+  try {
+    size_t end = 0;
+    unsigned long long number = std::stoull(word, &end);
+    if (end == word.size() && word[0] != '-') {
+      return number;
+    }
+  } catch (const std::exception &) {
+  }
+  throw std::invalid_argument("expect a number, got \"" + word + "\"");
+}
+
+int64_t toIndex(const std::string &word) {
+  try {
+    size_t end = 0;
+    long long number = std::stoll(word, &end);
+    if (end == word.size()) {
+      return number;
+    }
+  } catch (const std::exception &) {
+  }
+  throw std::invalid_argument("expect a number, got \"" + word + "\"");
+}
+} // namespace
+
+Debugger::Debugger(const turing::machine::Machine &machine,
+                   std::string_view input)
+    : execution_(machine, input), breakpoints_(machine) {
+  execution_.journal();
+}
+
+void Debugger::repl(std::istream &in, std::ostream &out) {
+  std::string line;
+  out << PROMPT << std::flush;
+  while (std::getline(in, line)) {
+    try {
+      if (!execute(line, out)) {
+        return;
+      }
+    } catch (const std::invalid_argument &e) {
+      out << "error: " << e.what() << "\n";
+    }
+    out << PROMPT << std::flush;
+  }
+}
+
+std::optional<std::string> Debugger::resume() {
+  BreakpointObserver observer{breakpoints_};
+  turing::machine::runObserved(execution_, observer);
+  return observer.reason();
+}
+
+turing::machine::Execution &Debugger::execution() { return execution_; }
+
+Breakpoints &Debugger::breakpoints() { return breakpoints_; }
+
+bool Debugger::execute(const std::string &line, std::ostream &out) {
+  std::istringstream stream{line};
+  std::vector<std::string> words;
+  for (std::string word; stream >> word;) {
+    words.push_back(word);
+  }
+  if (words.empty()) {
+    return true;
+  }
+
+  const std::string &command = words[0];
+  auto countOf = [&words]() { return words.size() > 1 ? toSize(words[1]) : 1; };
+
+  if (command == "quit" || command == "q") {
+    return false;
+  } else if (command == "help" || command == "h") {
+    out << HELP << "\n";
+  } else if (command == "break" && words.size() == 3 && words[1] == "state") {
+    breakpoints_.onState(words[2]);
+  } else if (command == "break" && words.size() == 3 && words[1] == "read") {
+    breakpoints_.onRead(words[2]);
+  } else if (command == "break" && words.size() == 4 && words[1] == "fire") {
+    breakpoints_.onFire(words[2], words[3]);
+  } else if (command == "break" && words.size() == 4 && words[1] == "head") {
+    breakpoints_.onHead(toSize(words[2]), toIndex(words[3]));
+  } else if (command == "break" && words.size() == 3 && words[1] == "step") {
+    breakpoints_.onStep(toSize(words[2]));
+  } else if (command == "info") {
+    const std::vector<std::string> &descriptions = breakpoints_.descriptions();
+    for (size_t i = 0; i < descriptions.size(); ++i) {
+      out << i << ": " << descriptions[i] << "\n";
+    }
+  } else if (command == "delete") {
+    breakpoints_.clear();
+  } else if (command == "continue" || command == "c") {
+    if (std::optional<std::string> reason = resume()) {
+      out << "Breakpoint " << reason.value() << "\n";
+    }
+    report(out);
+  } else if (command == "step" || command == "s") {
+    for (size_t i = countOf(); i > 0 && execution_.step(); --i) {
+    }
+    report(out);
+  } else if (command == "back" || command == "b") {
+    for (size_t i = countOf(); i > 0 && execution_.back(); --i) {
+    }
+    report(out);
+  } else if (command == "goto" && words.size() == 2) {
+    if (!execution_.seek(toSize(words[1]))) {
+      out << "step " << words[1] << " cannot be reached\n";
+    }
+    report(out);
+  } else if (command == "print" || command == "p") {
+    out << execution_.tapes().id();
+  } else {
+    throw std::invalid_argument("unknown command, try help");
+  }
+
+  return true;
+}
+
+void Debugger::report(std::ostream &out) const {
+  const turing::machine::Tapes &tapes = execution_.tapes();
+
+  out << "Step " << tapes.steps() << ", State " << tapes.currentState();
+  if (execution_.isHalted()) {
+    out << ", halted " << (tapes.isAccepted() ? "(ACCEPTED)" : "(UNACCEPTED)");
+  }
+  out << "\n";
+}
+
+} // namespace turing::debug
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "turing/debug/breakpoint.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+
+namespace turing::debug {
+
+// Runs a machine on one input under control of line commands, see HELP in
+// debugger.cpp. Every step is journaled, so the run can also go backwards.
+class Debugger {
+public:
+  Debugger(const turing::machine::Machine &machine, std::string_view input);
+
+  // answer commands read from in until quit or the end of in
+  void repl(std::istream &in, std::ostream &out);
+
+  // run until a breakpoint is hit, which is returned, or the machine halts
+  std::optional<std::string> resume();
+
+  turing::machine::Execution &execution();
+  Breakpoints &breakpoints();
+
+private:
+  turing::machine::Execution execution_;
+  Breakpoints breakpoints_;
+
+  // return false on quit
+  bool execute(const std::string &line, std::ostream &out);
+  void report(std::ostream &out) const;
+};
+
+} // namespace turing::debug
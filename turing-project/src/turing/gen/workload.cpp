@@ -0,0 +1,301 @@
+#include "turing/gen/workload.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "turing/util/number.hpp"
+
+namespace turing::gen {
+
+namespace {
+using turing::util::number::mix;
+
+constexpr char BLANK = '_';
+
+// writes .tm statements, the header first since it lists every state
+class Writer {
+public:
+  explicit Writer(std::ostream &out) : out_(out) {}
+
+  void header(const std::vector<std::string> &states,
+              const std::string &inputSymbols, const std::string &tapeSymbols,
+              const std::string &start, const std::string &final,
+              size_t nTape) {
+    out_ << "#Q = {";
+    for (size_t i = 0; i < states.size(); ++i) {
+      out_ << (i == 0 ? "" : ",") << states[i];
+    }
+    out_ << "}\n";
+    out_ << "#S = {" << join(inputSymbols) << "}\n";
+    out_ << "#G = {" << join(tapeSymbols + BLANK) << "}\n";
+    out_ << "#q0 = " << start << "\n";
+    out_ << "#B = " << BLANK << "\n";
+    out_ << "#F = {" << final << "}\n";
+    out_ << "#N = " << nTape << "\n\n";
+  }
+
+  void rule(const std::string &state, const std::string &oldSigns,
+            const std::string &newSigns, const std::string &directions,
+            const std::string &next) {
+    out_ << state << " " << oldSigns << " " << newSigns << " " << directions
+         << " " << next << "\n";
+  }
+
+private:
+  std::ostream &out_;
+
+  static std::string join(const std::string &symbols) {
+    std::string s;
+    for (char symbol : symbols) {
+      s += s.empty() ? "" : ",";
+      s += symbol;
+    }
+    return s;
+  }
+};
+
+// nTape signs that are rest except sign on tape
+std::string only(size_t nTape, size_t tape, char sign, char rest = '*') {
+  std::string signs(nTape, rest);
+  signs[tape] = sign;
+  return signs;
+}
+
+std::string randomString(const std::string &symbols, size_t length,
+                         uint64_t seed) {
+  std::string s(length, '\0');
+  for (size_t i = 0; i < length; ++i) {
+    s[i] = symbols[mix(seed ^ mix(i)) % symbols.size()];
+  }
+  return s;
+}
+
+void counter(const WorkloadOption &option, std::ostream &tm,
+             std::ostream &input) {
+  Writer writer{tm};
+  writer.header({"scan", "inc", "back", "halt"}, "1", "10", "scan", "halt", 2);
+  // the counter lives on tape 1, least significant bit at index 0
+  writer.rule("scan", "1*", "**", "r*", "inc");
+  writer.rule("scan", "_*", "**", "**", "halt");
+  writer.rule("inc", "*1", "*0", "*r", "inc");
+  writer.rule("inc", "*0", "*1", "*l", "back");
+  writer.rule("inc", "*_", "*1", "*l", "back");
+  writer.rule("back", "*0", "**", "*l", "back");
+  writer.rule("back", "*1", "**", "*l", "back");
+  writer.rule("back", "*_", "**", "*r", "scan");
+  input << std::string(option.size, '1');
+}
+
+void copy(const WorkloadOption &option, std::ostream &tm,
+          std::ostream &input) {
+  Writer writer{tm};
+  writer.header({"copy", "halt"}, "ab", "ab", "copy", "halt", 2);
+  writer.rule("copy", "a_", "aa", "rr", "copy");
+  writer.rule("copy", "b_", "bb", "rr", "copy");
+  writer.rule("copy", "__", "__", "**", "halt");
+  input << randomString("ab", option.size, option.seed);
+}
+
+void reverse(const WorkloadOption &option, std::ostream &tm,
+             std::ostream &input) {
+  Writer writer{tm};
+  writer.header({"seek", "take", "rewind", "put", "halt"}, "ab", "ab", "seek",
+                "halt", 2);
+  // move the input backwards onto tape 1, then forward back onto tape 0
+  writer.rule("seek", "a_", "**", "r*", "seek");
+  writer.rule("seek", "b_", "**", "r*", "seek");
+  writer.rule("seek", "__", "**", "l*", "take");
+  writer.rule("take", "a_", "_a", "lr", "take");
+  writer.rule("take", "b_", "_b", "lr", "take");
+  writer.rule("take", "__", "**", "rl", "rewind");
+  writer.rule("rewind", "_a", "**", "*l", "rewind");
+  writer.rule("rewind", "_b", "**", "*l", "rewind");
+  writer.rule("rewind", "__", "**", "*r", "put");
+  writer.rule("put", "_a", "a_", "rr", "put");
+  writer.rule("put", "_b", "b_", "rr", "put");
+  writer.rule("put", "__", "**", "**", "halt");
+  input << randomString("ab", option.size, option.seed);
+}
+
+void multiply(const WorkloadOption &option, std::ostream &tm,
+              std::ostream &input) {
+  Writer writer{tm};
+  writer.header({"move", "back", "next", "skip", "add", "ret", "halt"}, "1x",
+                "1xX", "move", "halt", 2);
+  // move the factors to tape 1 and build the product on tape 0
+  writer.rule("move", "1_", "_1", "rr", "move");
+  writer.rule("move", "x_", "_x", "rr", "move");
+  writer.rule("move", "__", "**", "*l", "back");
+  writer.rule("back", "_1", "**", "*l", "back");
+  writer.rule("back", "_x", "**", "*l", "back");
+  writer.rule("back", "__", "**", "*r", "next");
+  // mark a 1 of the first factor, then append the second factor
+  writer.rule("next", "_1", "_X", "*r", "skip");
+  writer.rule("next", "_x", "**", "**", "halt");
+  writer.rule("skip", "_1", "**", "*r", "skip");
+  writer.rule("skip", "_x", "**", "*r", "add");
+  writer.rule("add", "_1", "1*", "rr", "add");
+  writer.rule("add", "__", "**", "*l", "ret");
+  writer.rule("ret", "*1", "**", "*l", "ret");
+  writer.rule("ret", "*x", "**", "*l", "ret");
+  writer.rule("ret", "*X", "**", "*r", "next");
+  input << std::string(option.size, '1') << 'x'
+        << std::string(option.size, '1');
+}
+
+// busy beaver candidates start on a blank tape, so the input is left empty
+void beaver(const WorkloadOption &option, std::ostream &tm, std::ostream &) {
+  if (option.size == 0) {
+    throw std::invalid_argument("beaver needs at least one state");
+  }
+  size_t n = option.size;
+
+  std::vector<std::string> states;
+  for (size_t i = 0; i < n; ++i) {
+    states.push_back("s" + std::to_string(i));
+  }
+  states.push_back("halt");
+
+  Writer writer{tm};
+  writer.header(states, "1", "1", "s0", "halt", 1);
+
+  // one rule halts, never the first one fired (s0 reading blank)
+  uint64_t state = mix(option.seed);
+  size_t halting = 1 + state % (2 * n - 1);
+  for (size_t i = 0; i < 2 * n; ++i) {
+    state = mix(state);
+    std::string read{i % 2 == 0 ? BLANK : '1'};
+    std::string write{state & 1 ? '1' : BLANK};
+    std::string direction{state & 2 ? 'r' : 'l'};
+    std::string next = i == halting ? "halt" : states[(state >> 2) % n];
+    writer.rule(states[i / 2], read, write, direction, next);
+  }
+}
+
+void shuffle(const WorkloadOption &option, std::ostream &tm,
+             std::ostream &input) {
+  if (option.nTape < 2) {
+    throw std::invalid_argument("shuffle needs at least 2 tapes");
+  }
+  const size_t k = option.nTape;
+  const std::string symbols = "abcd";
+
+  auto deal = [](size_t i) { return "deal" + std::to_string(i); };
+  auto rewind = [](size_t i) { return "rewind" + std::to_string(i); };
+  auto gather = [](size_t i) { return "gather" + std::to_string(i); };
+
+  std::vector<std::string> states;
+  for (size_t i = 1; i < k; ++i) {
+    states.insert(states.end(), {deal(i), rewind(i), gather(i)});
+  }
+  states.push_back("halt");
+
+  Writer writer{tm};
+  writer.header(states, symbols, symbols, deal(1), "halt", k);
+
+  const std::string keep(k, '*');
+  for (size_t i = 1; i < k; ++i) {
+    // deal the input round robin over tapes 1 .. k-1, erasing tape 0
+    for (char symbol : symbols) {
+      std::string read = only(k, i, BLANK);
+      read[0] = symbol;
+      std::string write = only(k, i, symbol);
+      write[0] = BLANK;
+      std::string directions = only(k, i, 'r');
+      directions[0] = 'r';
+      writer.rule(deal(i), read, write, directions, deal(i % (k - 1) + 1));
+    }
+    writer.rule(deal(i), only(k, 0, BLANK), keep, only(k, 1, 'l'), rewind(1));
+
+    // rewind tape i, then append it to tape 0
+    for (char symbol : symbols) {
+      writer.rule(rewind(i), only(k, i, symbol), keep, only(k, i, 'l'),
+                  rewind(i));
+      std::string read = only(k, i, symbol);
+      read[0] = BLANK;
+      std::string directions = only(k, i, 'r');
+      directions[0] = 'r';
+      writer.rule(gather(i), read, only(k, 0, symbol), directions, gather(i));
+    }
+    writer.rule(rewind(i), only(k, i, BLANK), keep, only(k, i, 'r'),
+                gather(i));
+    std::string read = only(k, i, BLANK);
+    read[0] = BLANK;
+    if (i + 1 < k) {
+      writer.rule(gather(i), read, keep, only(k, i + 1, 'l'), rewind(i + 1));
+    } else {
+      writer.rule(gather(i), read, keep, keep, "halt");
+    }
+  }
+
+  input << randomString(symbols, option.size, option.seed);
+}
+
+void chain(const WorkloadOption &option, std::ostream &tm,
+           std::ostream &input) {
+  if (option.size == 0) {
+    throw std::invalid_argument("chain needs at least one state");
+  }
+  size_t n = option.size;
+
+  std::vector<std::string> states;
+  states.reserve(n + 1);
+  for (size_t i = 0; i < n; ++i) {
+    states.push_back("q" + std::to_string(i));
+  }
+  states.push_back("halt");
+
+  Writer writer{tm};
+  writer.header(states, "01", "01", "q0", "halt", 1);
+  for (size_t i = 0; i < n; ++i) {
+    // flip every bit, jumping to a pseudo random state
+    writer.rule(states[i], "0", "1", "r",
+                states[mix(option.seed ^ mix(2 * i)) % n]);
+    writer.rule(states[i], "1", "0", "r",
+                states[mix(option.seed ^ mix(2 * i + 1)) % n]);
+    writer.rule(states[i], "_", "_", "*", "halt");
+  }
+
+  input << randomString("01", n, option.seed);
+}
+
+using Generator = std::function<void(const WorkloadOption &, std::ostream &,
+                                     std::ostream &)>;
+
+const std::map<std::string, Generator> &generators() {
+  static const std::map<std::string, Generator> GENERATORS = {
+      {"counter", counter}, {"copy", copy},       {"reverse", reverse},
+      {"multiply", multiply}, {"beaver", beaver}, {"shuffle", shuffle},
+      {"chain", chain},
+  };
+  return GENERATORS;
+}
+} // namespace
+
+const std::vector<std::string> &kinds() {
+  static const std::vector<std::string> KINDS = [] {
+    std::vector<std::string> kinds;
+    for (const auto &[kind, _] : generators()) {
+      kinds.push_back(kind);
+    }
+    return kinds;
+  }();
+  return KINDS;
+}
+
+void generate(const std::string &kind, const WorkloadOption &option,
+              std::ostream &tm, std::ostream &input) {
+  auto it = generators().find(kind);
+  if (it == generators().end()) {
+    throw std::invalid_argument("unknown workload " + kind);
+  }
+  it->second(option, tm, input);
+}
+
+} // namespace turing::gen
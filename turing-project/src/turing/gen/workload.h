@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace turing::gen {
+
+struct WorkloadOption {
+  size_t size;   // input length, or number of states for beaver and chain
+  size_t nTape;  // tapes of shuffle
+  uint64_t seed; // for random inputs and random machines
+};
+
+// kinds of workload generate() knows:
+//   counter   counts the 1s of the input in binary on tape 1
+//   copy      copies the input to tape 1
+//   reverse   reverses the input on tape 0
+//   multiply  1^a x 1^b into 1^(a*b), with a = b = size
+//   beaver    a random busy beaver candidate with size states
+//   shuffle   deals the input over nTape - 1 tapes and gathers them back
+//   chain     size states scrambling a size long input, 3 * size transitions
+const std::vector<std::string> &kinds();
+
+// Write a .tm program of kind to tm and a matching input to input, nothing
+// for a beaver, which starts on a blank tape. The output only depends on kind
+// and option. Throw std::invalid_argument for an
+// unknown kind or a size the kind does not support.
+void generate(const std::string &kind, const WorkloadOption &option,
+              std::ostream &tm, std::ostream &input);
+
+} // namespace turing::gen
@@ -0,0 +1,92 @@
+#include "turing/machine/alphabet.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TURING_ALPHABET_SSSE3 1
+#endif
+
+namespace turing::machine {
+
+namespace {
+
+#ifdef TURING_ALPHABET_SSSE3
+__attribute__((target("ssse3"))) size_t
+ssse3FindFirstNotOf(const std::array<uint8_t, 16> &lowNibbles,
+                    std::string_view text) {
+  const __m128i lowTable =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(lowNibbles.data()));
+  // bit hi for the ASCII high nibbles 0-7, nothing for bytes >= 0x80
+  const __m128i highTable = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0,
+                                          0, 0, 0, 0, 0, 0);
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i zero = _mm_setzero_si128();
+
+  size_t i = 0;
+  for (; i + 16 <= text.size(); i += 16) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + i));
+    __m128i low = _mm_shuffle_epi8(lowTable, _mm_and_si128(bytes, nibble));
+    __m128i high = _mm_shuffle_epi8(
+        highTable, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+    int outside =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), zero));
+    if (outside != 0) {
+      return i + __builtin_ctz(outside);
+    }
+  }
+  return i;
+}
+#endif
+
+} // namespace
+
+Alphabet::Alphabet(const std::unordered_set<char> &symbols)
+    : mask_{}, lowNibbles_{}, ascii_(true) {
+  for (char symbol : symbols) {
+    auto code = static_cast<uint8_t>(symbol);
+    mask_[code >> 6] |= uint64_t{1} << (code & 63);
+    if (code < 0x80) {
+      lowNibbles_[code & 0x0F] |= static_cast<uint8_t>(1u << (code >> 4));
+    } else {
+      ascii_ = false;
+    }
+  }
+}
+
+bool Alphabet::contains(char symbol) const {
+  auto code = static_cast<uint8_t>(symbol);
+  return (mask_[code >> 6] >> (code & 63)) & 1;
+}
+
+size_t Alphabet::findFirstNotOf(std::string_view text) const {
+  size_t from = 0;
+
+#ifdef TURING_ALPHABET_SSSE3
+  static const bool ssse3 = __builtin_cpu_supports("ssse3");
+  if (ascii_ && ssse3) {
+    from = ssse3FindFirstNotOf(lowNibbles_, text);
+    if (from < text.size() && !contains(text[from])) {
+      return from;
+    }
+  }
+#endif
+
+  return scalarFindFirstNotOf(text, from);
+}
+
+size_t Alphabet::scalarFindFirstNotOf(std::string_view text,
+                                      size_t from) const {
+  for (size_t i = from; i < text.size(); ++i) {
+    if (!contains(text[i])) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+} // namespace turing::machine
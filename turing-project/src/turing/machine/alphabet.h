@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+
+namespace turing::machine {
+
+// 256-bit membership mask over symbols, used to validate whole inputs at
+// once. Scanning uses SSSE3 nibble lookups when the CPU supports them and
+// every symbol is ASCII, which the .tm grammar guarantees.
+class Alphabet {
+public:
+  explicit Alphabet(const std::unordered_set<char> &symbols);
+
+  bool contains(char symbol) const;
+
+  // index of the first character of text that is not in the alphabet, or
+  // std::string_view::npos if there is none
+  size_t findFirstNotOf(std::string_view text) const;
+
+private:
+  std::array<uint64_t, 4> mask_;
+
+  // lowNibbles_[lo] has bit hi set iff symbol (hi << 4 | lo) is a member
+  std::array<uint8_t, 16> lowNibbles_;
+  bool ascii_;
+
+  size_t scalarFindFirstNotOf(std::string_view text, size_t from) const;
+};
+
+} // namespace turing::machine
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/profile.h"
+#include "turing/machine/symbols.h"
+#include "turing/machine/transition.h"
+#include "turing/util/string.h"
+
+namespace turing::machine {
+
+// A Machine compiled to dense tables for runs that only need the verdict,
+// the step count and the final content. States and symbols are numbered and
+// cells hold symbol codes. The transitions of a state are stored
+// together, exact ones before '*' patterns, so that the first one matching
+// in order is the one Machine::determineTransition picks.
+//
+// Given a profile, states are numbered from the hottest down so that the
+// tables of hot states are adjacent, and the exact transitions of a state
+// are ordered from the most frequent down.
+class CompiledMachine {
+public:
+  static constexpr uint32_t HALT = std::numeric_limits<uint32_t>::max();
+
+  CompiledMachine(const Machine &machine, SymbolTable symbols,
+                  const Profile *profile = nullptr);
+
+  size_t nState() const { return final_.size(); }
+  size_t nTape() const { return nTape_; }
+  size_t nTransition() const { return targets_.size(); }
+  uint32_t startState() const { return start_; }
+  bool isFinal(uint32_t state) const { return final_[state]; }
+  const SymbolTable &symbols() const { return symbols_; }
+  Code wildcard() const { return wildcard_; }
+
+  // transition fired in state when the heads read cells, HALT if none
+  uint32_t next(uint32_t state, const Code *cells) const {
+    for (uint32_t t = first_[state]; t < first_[state + 1]; ++t) {
+      const Code *old = &oldCells_[t * nTape_];
+      size_t i = 0;
+      while (i < nTape_ && (old[i] == cells[i] || old[i] == wildcard_)) {
+        ++i;
+      }
+      if (i == nTape_) {
+        return t;
+      }
+    }
+    return HALT;
+  }
+
+  // cells written by transition, the wildcard keeps a cell
+  const Code *newCells(uint32_t transition) const {
+    return &newCells_[transition * nTape_];
+  }
+  // head moves of transition, -1, 0 or 1
+  const int8_t *moves(uint32_t transition) const {
+    return &moves_[transition * nTape_];
+  }
+  uint32_t target(uint32_t transition) const { return targets_[transition]; }
+  // Transition::id of the Machine transition it was compiled from
+  size_t source(uint32_t transition) const { return sources_[transition]; }
+
+private:
+  SymbolTable symbols_;
+  size_t nTape_;
+  Code wildcard_;
+  uint32_t start_;
+  std::vector<bool> final_;
+  std::vector<uint32_t> first_; // state s owns transitions [first_[s], first_[s + 1])
+  std::vector<Code> oldCells_;  // nTape_ per transition
+  std::vector<Code> newCells_;
+  std::vector<int8_t> moves_;
+  std::vector<uint32_t> targets_;
+  std::vector<size_t> sources_;
+};
+
+inline CompiledMachine::CompiledMachine(const Machine &machine,
+                                        SymbolTable symbols,
+                                        const Profile *profile)
+    : symbols_(std::move(symbols)), nTape_(machine.nTape()),
+      wildcard_(symbols_.wildcard()) {
+  // states in order of first appearance, the start state first
+  std::unordered_map<std::string, uint32_t> seen;
+  std::vector<bool> final;
+  std::vector<std::vector<size_t>> owned; // Machine transitions per state
+  auto seenOf = [&](const std::string &state) {
+    auto [it, inserted] = seen.try_emplace(state, seen.size());
+    if (inserted) {
+      final.push_back(machine.finalStates().contains(state));
+      owned.emplace_back();
+    }
+    return it->second;
+  };
+
+  seenOf(machine.startState());
+  for (size_t id = 0; id < machine.nTransition(); ++id) {
+    const Transition &transition = machine.transition(id);
+    owned[seenOf(transition.oldState)].push_back(id);
+    seenOf(transition.newState);
+  }
+
+  auto hits = [profile](size_t id) {
+    return profile != nullptr ? profile->hits(id) : 0;
+  };
+  std::vector<uint64_t> heat(owned.size(), 0);
+  for (size_t state = 0; state < owned.size(); ++state) {
+    for (size_t id : owned[state]) {
+      heat[state] += hits(id);
+    }
+  }
+  std::vector<uint32_t> order(owned.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&heat](uint32_t a, uint32_t b) { return heat[a] > heat[b]; });
+
+  std::vector<uint32_t> ids(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    ids[order[i]] = static_cast<uint32_t>(i);
+  }
+  start_ = ids[0];
+  final_.resize(final.size());
+  for (size_t state = 0; state < final.size(); ++state) {
+    final_[ids[state]] = final[state];
+  }
+
+  auto append = [&](const Transition &transition) {
+    for (size_t i = 0; i < nTape_; ++i) {
+      oldCells_.push_back(symbols_.code(transition.oldSigns[i]));
+      newCells_.push_back(symbols_.code(transition.newSigns[i]));
+      moves_.push_back(transition.directions[i] == Direction::LEFT    ? -1
+                       : transition.directions[i] == Direction::RIGHT ? 1
+                                                                      : 0);
+    }
+    targets_.push_back(ids[seen.at(transition.newState)]);
+    sources_.push_back(transition.id);
+  };
+
+  for (uint32_t state : order) {
+    std::vector<size_t> &transitions = owned[state];
+    orderTransitions(machine, profile, transitions);
+    first_.push_back(static_cast<uint32_t>(targets_.size()));
+    for (size_t id : transitions) {
+      append(machine.transition(id));
+    }
+  }
+  first_.push_back(static_cast<uint32_t>(targets_.size()));
+}
+
+// Tape of symbol codes, unbounded both ways and entirely in memory
+class CellTape {
+public:
+  CellTape() : cells_(INITIAL, 0), origin_(INITIAL / 2), head_(origin_),
+               low_(head_), high_(head_) {}
+
+  // start over with input, encoded, from the head's cell rightwards
+  void reset(const std::vector<Code> &input) {
+    std::fill(cells_.begin() + low_, cells_.begin() + high_ + 1, 0);
+    head_ = origin_;
+    while (origin_ + input.size() >= cells_.size()) {
+      cells_.resize(cells_.size() * 2, 0);
+    }
+    std::copy(input.begin(), input.end(), cells_.begin() + origin_);
+    low_ = origin_;
+    high_ = origin_ + std::max<size_t>(input.size(), 1) - 1;
+  }
+
+  Code &current() { return cells_[head_]; }
+  Code current() const { return cells_[head_]; }
+
+  void move(int8_t move) {
+    if (move < 0) {
+      if (head_ == 0) {
+        growLeft();
+      }
+      low_ = std::min(low_, --head_);
+    } else if (move > 0) {
+      if (++head_ == cells_.size()) {
+        cells_.resize(cells_.size() * 2, 0);
+      }
+      high_ = std::max(high_, head_);
+    }
+  }
+
+  // non-blank range, decoded
+  std::optional<std::string> content(const SymbolTable &symbols) const {
+    size_t first = low_;
+    size_t last = high_ + 1;
+    while (first < last && cells_[first] == 0) {
+      ++first;
+    }
+    while (last > first && cells_[last - 1] == 0) {
+      --last;
+    }
+    if (first == last) {
+      return std::nullopt;
+    }
+
+    std::string s(last - first, '\0');
+    std::transform(cells_.begin() + first, cells_.begin() + last, s.begin(),
+                   [&symbols](Code cell) { return symbols.symbol(cell); });
+    return s;
+  }
+
+private:
+  static constexpr size_t INITIAL = 64;
+
+  std::vector<Code> cells_; // blank is code 0
+  size_t origin_;
+  size_t head_;
+  // every cell the head or the input reached lies in [low_, high_]
+  size_t low_;
+  size_t high_;
+
+  void growLeft() {
+    size_t added = cells_.size();
+    cells_.insert(cells_.begin(), added, 0);
+    origin_ += added;
+    head_ += added;
+    low_ += added;
+    high_ += added;
+  }
+};
+
+// Run of a CompiledMachine. Only tracks what a verdict needs: the state, the
+// step count, whether a final state was entered, and the tapes.
+class CompiledExecution {
+public:
+  explicit CompiledExecution(const CompiledMachine &machine)
+      : machine_(machine), tapes_(machine.nTape()), cells_(machine.nTape(), 0),
+        state_(0), next_(CompiledMachine::HALT), steps_(0),
+        accepted_(false) {}
+
+  // start over on input, whose symbols must be input symbols of the machine
+  void reset(std::string_view input) {
+    input_.resize(input.size());
+    std::transform(input.begin(), input.end(), input_.begin(),
+                   [this](char symbol) {
+                     assert(symbol != turing::util::string::STAR &&
+                            machine_.symbols().code(symbol) !=
+                                machine_.symbols().wildcard());
+                     return machine_.symbols().code(symbol);
+                   });
+
+    tapes_[0].reset(input_);
+    input_.clear();
+    for (size_t i = 1; i < tapes_.size(); ++i) {
+      tapes_[i].reset(input_);
+    }
+    for (size_t i = 0; i < tapes_.size(); ++i) {
+      cells_[i] = tapes_[i].current();
+    }
+
+    state_ = machine_.startState();
+    steps_ = 0;
+    accepted_ = machine_.isFinal(state_);
+    next_ = machine_.next(state_, cells_.data());
+  }
+
+  // apply the next transition, return false once the machine halts
+  bool step() {
+    if (next_ == CompiledMachine::HALT) {
+      return false;
+    }
+
+    const Code *write = machine_.newCells(next_);
+    const int8_t *moves = machine_.moves(next_);
+    for (size_t i = 0; i < tapes_.size(); ++i) {
+      CellTape &tape = tapes_[i];
+      if (write[i] != machine_.wildcard()) {
+        tape.current() = write[i];
+      }
+      tape.move(moves[i]);
+      cells_[i] = tape.current();
+    }
+
+    state_ = machine_.target(next_);
+    accepted_ = accepted_ || machine_.isFinal(state_);
+    ++steps_;
+    next_ = machine_.next(state_, cells_.data());
+    return true;
+  }
+
+  bool isHalted() const { return next_ == CompiledMachine::HALT; }
+  bool isAccepted() const { return accepted_; }
+  size_t steps() const { return steps_; }
+  uint32_t state() const { return state_; }
+  // transition fired by the next step, HALT once halted
+  uint32_t next() const { return next_; }
+  // non-blank range of tape 0
+  std::optional<std::string> content() const {
+    return tapes_[0].content(machine_.symbols());
+  }
+
+private:
+  const CompiledMachine &machine_;
+  std::vector<CellTape> tapes_;
+  std::vector<Code> cells_; // under the heads
+  std::vector<Code> input_; // encoding buffer
+  uint32_t state_;
+  uint32_t next_;
+  size_t steps_;
+  bool accepted_;
+};
+
+// compile machine, laid out by profile if given
+inline CompiledMachine compile(const Machine &machine,
+                               const Profile *profile = nullptr) {
+  return CompiledMachine{machine, SymbolTable{machine}, profile};
+}
+
+} // namespace turing::machine
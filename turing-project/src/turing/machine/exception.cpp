@@ -1,3 +1,10 @@
 #include "turing/machine/exception.h"
 
-turing::machine::InvalidInputException::InvalidInputException(const std::string &msg) : std::runtime_error(msg) {}
\ No newline at end of file
+turing::machine::InvalidInputException::InvalidInputException(const std::string &msg) : std::runtime_error(msg) {}
+
+turing::machine::InvalidSymbolException::InvalidSymbolException(size_t index, char symbol)
+    : InvalidInputException("illegal input string"), index_(index), symbol_(symbol) {}
+
+size_t turing::machine::InvalidSymbolException::index() const { return index_; }
+
+char turing::machine::InvalidSymbolException::symbol() const { return symbol_; }
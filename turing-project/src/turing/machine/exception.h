@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <stdexcept>
 
 namespace turing::machine {
@@ -7,4 +8,17 @@ class InvalidInputException : public std::runtime_error {
 public:
   explicit InvalidInputException(const std::string &msg);
 }; 
-}
\ No newline at end of file
+
+// a symbol outside the input alphabet, found while streaming the input
+class InvalidSymbolException : public InvalidInputException {
+public:
+  InvalidSymbolException(size_t index, char symbol);
+
+  size_t index() const;
+  char symbol() const;
+
+private:
+  size_t index_;
+  char symbol_;
+};
+}
@@ -0,0 +1,105 @@
+#include "turing/machine/execution.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "turing/machine/journal.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/stream.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+#include "turing/util/generator.hpp"
+
+namespace turing::machine {
+
+Execution::Execution(const Machine &machine, std::string_view input)
+    : machine_(machine),
+      tapes_(input, machine.startState(), machine.finalStates(),
+             machine.nTape(), machine.blankSymbol()),
+      next_(machine.determineTransition(tapes_.currentView())) {}
+
+Execution::Execution(const Machine &machine, StreamInput &input)
+    : machine_(machine),
+      tapes_(input, machine.startState(), machine.finalStates(),
+             machine.nTape(), machine.blankSymbol()),
+      next_(machine.determineTransition(tapes_.currentView())) {}
+
+void Execution::reset(std::string_view input) {
+  journal_.reset();
+  tapes_.reset(input, machine_.startState());
+  next_ = machine_.determineTransition(tapes_.currentView());
+}
+
+bool Execution::step() {
+  if (next_ == nullptr) {
+    return false;
+  }
+
+  if (journal_ != nullptr) {
+    tapes_.currentSigns(signs_.data());
+    journal_->push(next_->id, signs_.data());
+  }
+
+  tapes_.step(*next_);
+  next_ = machine_.determineTransition(tapes_.currentView());
+
+  return true;
+}
+
+bool Execution::isHalted() const { return next_ == nullptr; }
+
+const Transition *Execution::next() const { return next_; }
+
+void Execution::journal(size_t capacity) {
+  journal_ = std::make_unique<Journal>(machine_.nTransition(),
+                                       machine_.nTape(), capacity);
+  signs_.resize(machine_.nTape());
+}
+
+bool Execution::back() {
+  if (journal_ == nullptr || journal_->empty()) {
+    return false;
+  }
+
+  // the undone transition is the one that fires next
+  next_ = &machine_.transition(journal_->pop(signs_.data()));
+  tapes_.undo(*next_, signs_.data());
+  return true;
+}
+
+bool Execution::seek(size_t step) {
+  while (tapes_.steps() > step) {
+    if (!back()) {
+      return false;
+    }
+  }
+  while (tapes_.steps() < step) {
+    if (!this->step()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const Journal *Execution::journal() const { return journal_.get(); }
+
+turing::util::Generator<const Tapes &> Execution::steps(size_t stride,
+                                                        size_t maxSteps) {
+  while (true) {
+    for (size_t i = 0; i < stride && tapes_.steps() < maxSteps && step(); ++i) {
+    }
+
+    co_yield tapes_;
+
+    if (isHalted() || tapes_.steps() >= maxSteps) {
+      co_return;
+    }
+  }
+}
+
+Tapes &Execution::tapes() { return tapes_; }
+
+const Tapes &Execution::tapes() const { return tapes_; }
+
+} // namespace turing::machine
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turing/machine/journal.h"
+#include "turing/machine/stream.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+#include "turing/util/generator.hpp"
+
+namespace turing::machine {
+
+class Machine;
+
+// Per-run state of a Machine. The machine is only read through its const
+// interface, so executions on different threads may share one Machine.
+class Execution {
+public:
+  Execution(const Machine &machine, std::string_view input);
+  Execution(const Machine &machine, StreamInput &input);
+
+  // start a new run on input, reusing the tape buffers of this one. Stops
+  // journaling.
+  void reset(std::string_view input);
+
+  // apply the next transition, return false once the machine halts
+  bool step();
+  bool isHalted() const;
+  // transition fired by the next step, null once halted
+  const Transition *next() const;
+
+  // record every step from now on in a Journal holding at most capacity
+  // bytes, so that they can be undone
+  void journal(size_t capacity = Journal::CAPACITY);
+  // undo the last step, return false when no recorded step is left
+  bool back();
+  // go back or forward to step, return false if it cannot be reached
+  bool seek(size_t step);
+  const Journal *journal() const;
+
+  // Step lazily: every resume runs up to stride steps and yields the
+  // configuration in place. The generator finishes after yielding the
+  // configuration the machine halted in, or once maxSteps steps are done.
+  // The execution must outlive the generator.
+  turing::util::Generator<const Tapes &>
+  steps(size_t stride = 1,
+        size_t maxSteps = std::numeric_limits<size_t>::max());
+
+  Tapes &tapes();
+  const Tapes &tapes() const;
+
+private:
+  const Machine &machine_;
+  Tapes tapes_;
+  const Transition *next_;
+  std::unique_ptr<Journal> journal_;
+  std::vector<char> signs_; // symbols under the heads, for journal_
+};
+
+} // namespace turing::machine
@@ -0,0 +1,87 @@
+#include "turing/machine/journal.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace turing::machine {
+
+namespace {
+// bytes taken by a chunk of records
+constexpr size_t CHUNK_BYTES = 1 << 20;
+
+size_t idBytesOf(size_t nTransition) {
+  if (nTransition <= (size_t{1} << 8)) {
+    return 1;
+  }
+  if (nTransition <= (size_t{1} << 16)) {
+    return 2;
+  }
+  return 4;
+}
+} // namespace
+
+Journal::Journal(size_t nTransition, size_t nTape, size_t capacity)
+    : idBytes_(idBytesOf(nTransition)), nTape_(nTape),
+      chunkRecords_(CHUNK_BYTES / (idBytes_ + nTape)),
+      maxChunks_(std::max<size_t>(capacity / CHUNK_BYTES, 2)), tail_(0) {}
+
+void Journal::push(size_t transition, const char *signs) {
+  if (chunks_.empty() || tail_ == chunkRecords_) {
+    std::unique_ptr<uint8_t[]> chunk;
+    if (chunks_.size() == maxChunks_) {
+      // the ring is full, forget the oldest steps
+      chunk = std::move(chunks_.front());
+      chunks_.pop_front();
+    } else if (spare_ != nullptr) {
+      chunk = std::move(spare_);
+    } else {
+      chunk = std::make_unique<uint8_t[]>(CHUNK_BYTES);
+    }
+    chunks_.push_back(std::move(chunk));
+    tail_ = 0;
+  }
+
+  uint8_t *slot = record(tail_++);
+  for (size_t i = 0; i < idBytes_; ++i) {
+    slot[i] = static_cast<uint8_t>(transition >> (8 * i));
+  }
+  std::memcpy(slot + idBytes_, signs, nTape_);
+}
+
+size_t Journal::pop(char *signs) {
+  assert(!empty());
+
+  const uint8_t *slot = record(--tail_);
+  size_t transition = 0;
+  for (size_t i = 0; i < idBytes_; ++i) {
+    transition |= static_cast<size_t>(slot[i]) << (8 * i);
+  }
+  std::memcpy(signs, slot + idBytes_, nTape_);
+
+  if (tail_ == 0) {
+    spare_ = std::move(chunks_.back());
+    chunks_.pop_back();
+    tail_ = chunkRecords_;
+  }
+
+  return transition;
+}
+
+bool Journal::empty() const { return chunks_.empty(); }
+
+size_t Journal::size() const {
+  return chunks_.empty() ? 0 : (chunks_.size() - 1) * chunkRecords_ + tail_;
+}
+
+size_t Journal::bytesPerStep() const { return idBytes_ + nTape_; }
+
+uint8_t *Journal::record(size_t index) const {
+  return chunks_.back().get() + index * (idBytes_ + nTape_);
+}
+
+} // namespace turing::machine
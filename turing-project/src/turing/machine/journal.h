@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace turing::machine {
+
+// Undo log of a run. Each step is recorded as the id of the transition it
+// fired, in as few bytes as the number of transitions allows, followed by
+// the symbol it overwrote on every tape. Everything else about the previous
+// configuration follows from the transition.
+//
+// Records live in fixed-size chunks used as a ring: once capacity bytes are
+// in use, the oldest chunk is recycled and its steps can no longer be undone.
+class Journal {
+public:
+  static constexpr size_t CAPACITY = size_t{1} << 30;
+
+  Journal(size_t nTransition, size_t nTape, size_t capacity = CAPACITY);
+
+  void push(size_t transition, const char *signs);
+  // remove the newest record, write its signs and return its transition
+  size_t pop(char *signs);
+
+  bool empty() const;
+  size_t size() const; // steps that can be undone
+  size_t bytesPerStep() const;
+
+private:
+  const size_t idBytes_;
+  const size_t nTape_;
+  const size_t chunkRecords_;
+  const size_t maxChunks_;
+
+  std::deque<std::unique_ptr<uint8_t[]>> chunks_;
+  std::unique_ptr<uint8_t[]> spare_; // last chunk emptied by pop
+  size_t tail_; // records in chunks_.back(), the others are full
+
+  uint8_t *record(size_t index) const;
+};
+
+} // namespace turing::machine
@@ -0,0 +1,275 @@
+#include "turing/machine/lockstep.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TURING_LOCKSTEP_AVX2 1
+#endif
+
+namespace turing::machine {
+
+namespace {
+constexpr size_t LANES = LockstepLanes::LANES;
+
+// lanes one at a time, skipping those that stopped
+uint32_t stepEach(const LockstepTable &table, LockstepLanes &lanes,
+                  uint32_t maxSteps) {
+  const size_t nTape = table.nTape();
+  const uint32_t window = static_cast<uint32_t>(lanes.window);
+  uint32_t stopped = 0;
+
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    if (lanes.live[lane] == 0) {
+      continue;
+    }
+
+    uint32_t key = lanes.state[lane] * table.stateStride();
+    for (size_t t = 0; t < nTape; ++t) {
+      key += lanes.cells[lanes.heads[t * LANES + lane]] * table.weights()[t];
+    }
+    uint32_t transition = table.actions()[key];
+    if (transition == LockstepTable::HALT ||
+        lanes.steps[lane] == maxSteps) {
+      lanes.status[lane] = transition == LockstepTable::HALT
+                               ? LockstepLanes::HALTED
+                               : LockstepLanes::OUT_OF_STEPS;
+      lanes.live[lane] = 0;
+      stopped |= uint32_t{1} << lane;
+      continue;
+    }
+
+    bool escaped = false;
+    for (size_t t = 0; t < nTape; ++t) {
+      int32_t &head = lanes.heads[t * LANES + lane];
+      uint32_t write = table.writes()[transition * nTape + t];
+      if (write != LockstepTable::KEEP) {
+        lanes.cells[head] = write;
+      }
+      head += table.moves()[transition * nTape + t];
+      escaped |= static_cast<uint32_t>(head - lanes.low[t * LANES + lane]) >=
+                 window;
+    }
+    lanes.state[lane] = table.targets()[transition];
+    lanes.accepted[lane] |= table.finals()[lanes.state[lane]];
+    ++lanes.steps[lane];
+
+    if (escaped) {
+      lanes.status[lane] = LockstepLanes::ESCAPED;
+      lanes.live[lane] = 0;
+      stopped |= uint32_t{1} << lane;
+    }
+  }
+  return stopped;
+}
+
+#ifdef TURING_LOCKSTEP_AVX2
+__attribute__((target("avx2"))) inline __m256i load(const void *p) {
+  return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+}
+
+__attribute__((target("avx2"))) inline void store(void *p, __m256i v) {
+  _mm256_storeu_si256(static_cast<__m256i *>(p), v);
+}
+
+// 8 lanes per vector, every table read a masked gather. AVX2 has no
+// scatter, so the cells written are stored lane by lane.
+__attribute__((target("avx2"))) uint32_t
+stepAvx2(const LockstepTable &table, LockstepLanes &lanes, uint32_t maxSteps) {
+  static constexpr size_t WIDTH = 8;
+
+  const size_t nTape = table.nTape();
+  const int *cells = reinterpret_cast<const int *>(lanes.cells.data());
+  const int *actions = reinterpret_cast<const int *>(table.actions());
+  const int *writes = reinterpret_cast<const int *>(table.writes());
+  const int *moves = table.moves();
+  const int *targets = reinterpret_cast<const int *>(table.targets());
+  const int *finals = reinterpret_cast<const int *>(table.finals());
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i halt =
+      _mm256_set1_epi32(static_cast<int>(LockstepTable::HALT));
+  const __m256i keep =
+      _mm256_set1_epi32(static_cast<int>(LockstepTable::KEEP));
+  const __m256i budget = _mm256_set1_epi32(static_cast<int>(maxSteps));
+  const __m256i last = _mm256_set1_epi32(static_cast<int>(lanes.window - 1));
+  const __m256i tapes = _mm256_set1_epi32(static_cast<int>(nTape));
+  uint32_t stopped = 0;
+
+  for (size_t base = 0; base < LANES; base += WIDTH) {
+    __m256i live = load(&lanes.live[base]);
+    if (_mm256_testz_si256(live, live)) {
+      continue;
+    }
+
+    __m256i state = load(&lanes.state[base]);
+    __m256i key =
+        _mm256_mullo_epi32(state, _mm256_set1_epi32(table.stateStride()));
+    for (size_t t = 0; t < nTape; ++t) {
+      __m256i head = load(&lanes.heads[t * LANES + base]);
+      __m256i cell = _mm256_mask_i32gather_epi32(zero, cells, head, live, 4);
+      key = _mm256_add_epi32(
+          key, _mm256_mullo_epi32(
+                   cell, _mm256_set1_epi32(table.weights()[t])));
+    }
+    __m256i transition =
+        _mm256_mask_i32gather_epi32(halt, actions, key, live, 4);
+
+    __m256i steps = load(&lanes.steps[base]);
+    __m256i halted =
+        _mm256_and_si256(live, _mm256_cmpeq_epi32(transition, halt));
+    __m256i spent = _mm256_andnot_si256(
+        halted, _mm256_and_si256(live, _mm256_cmpeq_epi32(steps, budget)));
+    __m256i go = _mm256_andnot_si256(_mm256_or_si256(halted, spent), live);
+
+    __m256i first = _mm256_mullo_epi32(transition, tapes);
+    __m256i escaped = zero;
+    int32_t written[WIDTH];
+    int32_t at[WIDTH];
+    for (size_t t = 0; t < nTape; ++t) {
+      int32_t *heads = &lanes.heads[t * LANES + base];
+      __m256i index =
+          _mm256_add_epi32(first, _mm256_set1_epi32(static_cast<int>(t)));
+      __m256i write = _mm256_mask_i32gather_epi32(keep, writes, index, go, 4);
+      __m256i move = _mm256_mask_i32gather_epi32(zero, moves, index, go, 4);
+      __m256i head = load(heads);
+
+      uint32_t writing = static_cast<uint32_t>(_mm256_movemask_ps(
+          _mm256_castsi256_ps(_mm256_andnot_si256(
+              _mm256_cmpeq_epi32(write, keep), go))));
+      if (writing != 0) {
+        store(written, write);
+        store(at, head);
+        for (; writing != 0; writing &= writing - 1) {
+          size_t lane = static_cast<size_t>(std::countr_zero(writing));
+          lanes.cells[at[lane]] = static_cast<uint32_t>(written[lane]);
+        }
+      }
+
+      head = _mm256_add_epi32(head, move);
+      store(heads, head);
+      __m256i offset =
+          _mm256_sub_epi32(head, load(&lanes.low[t * LANES + base]));
+      escaped = _mm256_or_si256(
+          escaped, _mm256_or_si256(_mm256_cmpgt_epi32(zero, offset),
+                                   _mm256_cmpgt_epi32(offset, last)));
+    }
+    escaped = _mm256_and_si256(escaped, go);
+
+    state = _mm256_mask_i32gather_epi32(state, targets, transition, go, 4);
+    __m256i accepting =
+        _mm256_mask_i32gather_epi32(zero, finals, state, go, 4);
+    store(&lanes.state[base], state);
+    store(&lanes.accepted[base],
+          _mm256_or_si256(load(&lanes.accepted[base]), accepting));
+    store(&lanes.steps[base], _mm256_sub_epi32(steps, go));
+
+    __m256i status = load(&lanes.status[base]);
+    status = _mm256_blendv_epi8(
+        status, _mm256_set1_epi32(LockstepLanes::HALTED), halted);
+    status = _mm256_blendv_epi8(
+        status, _mm256_set1_epi32(LockstepLanes::OUT_OF_STEPS), spent);
+    status = _mm256_blendv_epi8(
+        status, _mm256_set1_epi32(LockstepLanes::ESCAPED), escaped);
+    store(&lanes.status[base], status);
+
+    __m256i stop = _mm256_or_si256(_mm256_or_si256(halted, spent), escaped);
+    store(&lanes.live[base], _mm256_andnot_si256(stop, live));
+    stopped |= static_cast<uint32_t>(
+                   _mm256_movemask_ps(_mm256_castsi256_ps(stop)))
+               << base;
+  }
+  return stopped;
+}
+#endif
+} // namespace
+
+LockstepTable::LockstepTable(const CompiledMachine &machine)
+    : nTape_(machine.nTape()), start_(machine.startState()) {
+  assert(fits(machine));
+  const uint32_t nCode = static_cast<uint32_t>(machine.symbols().size());
+
+  uint32_t weight = 1;
+  for (size_t i = 0; i < nTape_; ++i) {
+    weights_.push_back(weight);
+    weight *= nCode;
+  }
+  stateStride_ = weight;
+
+  // every combination of codes under the heads, as digits in base nCode
+  actions_.resize(machine.nState() * size_t{stateStride_});
+  std::vector<Code> cells(nTape_, 0);
+  for (uint32_t state = 0; state < machine.nState(); ++state) {
+    std::fill(cells.begin(), cells.end(), 0);
+    for (uint32_t key = 0; key < stateStride_; ++key) {
+      actions_[state * size_t{stateStride_} + key] =
+          machine.next(state, cells.data());
+      for (size_t i = 0; i < nTape_ && ++cells[i] == nCode; ++i) {
+        cells[i] = 0;
+      }
+    }
+  }
+  static_assert(CompiledMachine::HALT == HALT);
+
+  for (uint32_t t = 0; t < machine.nTransition(); ++t) {
+    for (size_t i = 0; i < nTape_; ++i) {
+      Code write = machine.newCells(t)[i];
+      writes_.push_back(write == machine.wildcard() ? KEEP : write);
+      moves_.push_back(machine.moves(t)[i]);
+    }
+    targets_.push_back(machine.target(t));
+  }
+  for (uint32_t state = 0; state < machine.nState(); ++state) {
+    finals_.push_back(machine.isFinal(state) ? 1 : 0);
+  }
+}
+
+uint32_t stepLanes(const LockstepTable &table, LockstepLanes &lanes,
+                   uint32_t maxSteps, bool simd) {
+#ifdef TURING_LOCKSTEP_AVX2
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  if (simd && avx2) {
+    return stepAvx2(table, lanes, maxSteps);
+  }
+#endif
+  return stepEach(table, lanes, maxSteps);
+}
+
+void LockstepExecution::place(size_t lane) {
+  clear(lane);
+  const std::string &input = inputs_[lane];
+  const size_t window = lanes_.window;
+
+  uint32_t *tape = &lanes_.cells[lane * window + origin_];
+  for (size_t i = 0; i < input.size(); ++i) {
+    tape[i] = machine_.symbols().code(input[i]);
+  }
+  for (size_t t = 0; t < table_.nTape(); ++t) {
+    lanes_.heads[t * LANES + lane] =
+        static_cast<int32_t>((t * LANES + lane) * window + origin_);
+  }
+
+  lanes_.state[lane] = table_.startState();
+  lanes_.steps[lane] = 0;
+  lanes_.accepted[lane] = table_.finals()[table_.startState()];
+  lanes_.live[lane] = ~uint32_t{0};
+  lanes_.status[lane] = LockstepLanes::RUNNING;
+  left_[lane] = 0;
+  right_[lane] = input.size();
+}
+
+void LockstepExecution::clear(size_t lane) {
+  for (size_t t = 0; t < table_.nTape(); ++t) {
+    uint32_t *origin =
+        &lanes_.cells[(t * LANES + lane) * lanes_.window + origin_];
+    std::fill(origin - left_[lane], origin + right_[lane], 0);
+  }
+}
+
+} // namespace turing::machine
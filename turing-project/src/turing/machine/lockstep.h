@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "turing/machine/compiled.hpp"
+
+namespace turing::machine {
+
+// A CompiledMachine flattened for lockstep runs. The transition fired in a
+// state is read from one dense table, indexed by the state and the codes
+// under all heads, so that lanes in different states find theirs with the
+// same gathers. Only machines whose table has at most MAX_ENTRIES entries
+// fit.
+class LockstepTable {
+public:
+  static constexpr uint32_t HALT = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t KEEP = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t MAX_ENTRIES = size_t{1} << 20;
+
+  static bool fits(const CompiledMachine &machine) {
+    size_t entries = machine.nState();
+    for (size_t i = 0; i < machine.nTape(); ++i) {
+      if (entries > MAX_ENTRIES / machine.symbols().size()) {
+        return false;
+      }
+      entries *= machine.symbols().size();
+    }
+    return entries <= MAX_ENTRIES;
+  }
+
+  // machine must fit
+  explicit LockstepTable(const CompiledMachine &machine);
+
+  size_t nTape() const { return nTape_; }
+  uint32_t startState() const { return start_; }
+  // transition fired in a state, HALT if none, at
+  // state * stateStride() + the sum of code * weights()[tape] over the tapes
+  const uint32_t *actions() const { return actions_.data(); }
+  uint32_t stateStride() const { return stateStride_; }
+  const uint32_t *weights() const { return weights_.data(); }
+  // nTape() per transition: the code written, KEEP for none, and the move
+  const uint32_t *writes() const { return writes_.data(); }
+  const int32_t *moves() const { return moves_.data(); }
+  const uint32_t *targets() const { return targets_.data(); }
+  // 1 for final states, 0 for the others
+  const uint32_t *finals() const { return finals_.data(); }
+
+private:
+  size_t nTape_;
+  uint32_t start_;
+  uint32_t stateStride_;
+  std::vector<uint32_t> actions_;
+  std::vector<uint32_t> weights_;
+  std::vector<uint32_t> writes_;
+  std::vector<int32_t> moves_;
+  std::vector<uint32_t> targets_;
+  std::vector<uint32_t> finals_;
+};
+
+// Configurations of LANES runs of one LockstepTable, structure-of-arrays.
+// Tape t of lane l is the window of cells [(t * LANES + l) * window, + window)
+// and heads hold absolute indexes into cells, so that the cells under the
+// heads of all lanes are one gather.
+struct LockstepLanes {
+  static constexpr size_t LANES = 16;
+
+  enum Status : uint32_t { RUNNING, HALTED, OUT_OF_STEPS, ESCAPED };
+
+  LockstepLanes(size_t nTape, size_t window)
+      : window(window), heads(nTape * LANES), low(nTape * LANES),
+        cells(nTape * LANES * window, 0) {
+    for (size_t i = 0; i < low.size(); ++i) {
+      low[i] = static_cast<int32_t>(i * window);
+    }
+  }
+
+  size_t window;
+  std::array<uint32_t, LANES> state{};
+  std::array<uint32_t, LANES> steps{};
+  std::array<uint32_t, LANES> accepted{}; // 0 or 1
+  std::array<uint32_t, LANES> live{};     // 0 or all ones
+  std::array<uint32_t, LANES> status{};
+  std::vector<int32_t> heads; // by tape, then lane
+  std::vector<int32_t> low;   // first cell of the window of heads[i]
+  std::vector<uint32_t> cells;
+};
+
+// Step every live lane once and return a bit for each lane that stopped,
+// with its status set: it halted, it is about to step past maxSteps, or its
+// head left its window. With simd, the lanes are stepped with AVX2 gathers
+// when the processor has them, each on its own otherwise.
+uint32_t stepLanes(const LockstepTable &table, LockstepLanes &lanes,
+                   uint32_t maxSteps, bool simd);
+
+// Verdicts of one machine over many inputs, run LANES at a time in lockstep
+// on the tables of a LockstepTable. A lane that stops is refilled with the
+// next input at once, so lanes only idle at the end. Once fewer than a
+// quarter of them are left, the rest are stepped on their own instead of
+// in masked vectors. A run whose input does not fit the window, or whose
+// head leaves it, is redone on a CompiledExecution.
+class LockstepExecution {
+public:
+  static constexpr size_t LANES = LockstepLanes::LANES;
+
+  // window is the number of cells of every tape of a lane, a quarter of
+  // them left of the input
+  LockstepExecution(const CompiledMachine &machine,
+                    const LockstepTable &table, size_t window, bool simd = true)
+      : machine_(machine), table_(table), lanes_(table.nTape(), window),
+        origin_(window / 4), simd_(simd), scalar_(machine), fallbacks_(0) {}
+
+  // Run count inputs, the i-th being written by the i-th call of
+  // next(std::string &), and call report(i, halted, accepted) for each, in
+  // no particular order. Runs stop after maxSteps steps like a sweep's.
+  template <typename Next, typename Report>
+  void run(size_t count, size_t maxSteps, Next next, Report report);
+
+  // runs redone on a CompiledExecution so far
+  size_t fallbacks() const { return fallbacks_; }
+
+private:
+  const CompiledMachine &machine_;
+  const LockstepTable &table_;
+  LockstepLanes lanes_;
+  size_t origin_;
+  bool simd_;
+  CompiledExecution scalar_;
+  size_t fallbacks_;
+
+  std::array<std::string, LANES> inputs_;
+  std::array<size_t, LANES> indexes_{};
+  // cells of a lane left and right of origin_ that its last run may have
+  // written, on every tape
+  std::array<size_t, LANES> left_{};
+  std::array<size_t, LANES> right_{};
+
+  // start inputs_[lane] in lane
+  void place(size_t lane);
+  void clear(size_t lane);
+  template <typename Report>
+  void runScalar(size_t index, const std::string &input, size_t maxSteps,
+                 Report &report);
+};
+
+template <typename Next, typename Report>
+void LockstepExecution::run(size_t count, size_t maxSteps, Next next,
+                            Report report) {
+  // step counts are 32-bit in the lanes
+  uint32_t budget = static_cast<uint32_t>(
+      std::min<size_t>(maxSteps, std::numeric_limits<uint32_t>::max()));
+  size_t given = 0;
+  size_t live = 0;
+
+  // fill lane with the next input that fits, return false once none is left
+  auto refill = [&](size_t lane) {
+    while (given < count) {
+      std::string &input = inputs_[lane];
+      next(input);
+      size_t index = given++;
+      if (input.size() + 1 > lanes_.window - origin_) {
+        runScalar(index, input, maxSteps, report);
+        continue;
+      }
+      indexes_[lane] = index;
+      place(lane);
+      return true;
+    }
+    return false;
+  };
+
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    live += refill(lane);
+  }
+
+  while (live > 0) {
+    bool crowded = given < count || live * 4 >= LANES;
+    uint32_t stopped = stepLanes(table_, lanes_, budget, simd_ && crowded);
+
+    for (; stopped != 0; stopped &= stopped - 1) {
+      size_t lane = static_cast<size_t>(std::countr_zero(stopped));
+      switch (lanes_.status[lane]) {
+      case LockstepLanes::HALTED:
+        report(indexes_[lane], true, lanes_.accepted[lane] != 0);
+        break;
+      case LockstepLanes::OUT_OF_STEPS:
+        if (budget < maxSteps) {
+          runScalar(indexes_[lane], inputs_[lane], maxSteps, report);
+        } else {
+          report(indexes_[lane], false, lanes_.accepted[lane] != 0);
+        }
+        break;
+      default:
+        runScalar(indexes_[lane], inputs_[lane], maxSteps, report);
+        break;
+      }
+
+      size_t steps = lanes_.steps[lane];
+      left_[lane] = std::min(origin_, steps);
+      right_[lane] = std::min(lanes_.window - origin_,
+                              std::max(inputs_[lane].size(), steps + 1));
+      if (!refill(lane)) {
+        --live;
+      }
+    }
+  }
+}
+
+template <typename Report>
+void LockstepExecution::runScalar(size_t index, const std::string &input,
+                                  size_t maxSteps, Report &report) {
+  ++fallbacks_;
+  scalar_.reset(input);
+  while (scalar_.steps() < maxSteps && scalar_.step()) {
+  }
+  report(index, scalar_.isHalted(), scalar_.isAccepted());
+}
+
+} // namespace turing::machine
@@ -0,0 +1,57 @@
+#include "turing/machine/loop.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+
+namespace turing::machine {
+
+LoopDetector::LoopDetector(uint64_t initial)
+    : saved_(initial), power_(1), length_(0) {}
+
+bool LoopDetector::observe(uint64_t hash) {
+  ++length_;
+  if (hash == saved_) {
+    return true;
+  }
+
+  // move the saved configuration up every power of two steps
+  if (length_ == power_) {
+    saved_ = hash;
+    power_ *= 2;
+    length_ = 0;
+  }
+  return false;
+}
+
+size_t LoopDetector::length() const { return length_; }
+
+std::optional<size_t> loopStart(const Machine &machine, std::string_view input,
+                                size_t length, size_t steps) {
+  Execution ahead{machine, input};
+  Execution behind{machine, input};
+  ahead.tapes().trackHash();
+  behind.tapes().trackHash();
+
+  for (size_t i = 0; i < length; ++i) {
+    ahead.step();
+  }
+
+  // once two configurations length steps apart are equal, all later ones
+  // are, so the first equal pair is the start
+  for (size_t start = 0; start + length <= steps; ++start) {
+    if (ahead.tapes().hash() == behind.tapes().hash() &&
+        ahead.tapes().isSameConfiguration(behind.tapes())) {
+      return start;
+    }
+    ahead.step();
+    behind.step();
+  }
+  return std::nullopt;
+}
+
+} // namespace turing::machine
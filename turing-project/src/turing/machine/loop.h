@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace turing::machine {
+
+class Machine;
+
+// Brent's cycle detection over the sequence of configuration hashes of a
+// run, fed one hash per step. Memory stays constant however long the run.
+class LoopDetector {
+public:
+  explicit LoopDetector(uint64_t initial);
+
+  // return true once hash closes a cycle, whose length is then length()
+  bool observe(uint64_t hash);
+  size_t length() const;
+
+private:
+  uint64_t saved_;
+  size_t power_;
+  size_t length_;
+};
+
+// Step at which a run of machine on input first enters its cycle of length
+// length, found by replaying two runs length steps apart, given that the
+// hashes at steps and steps - length matched. Configurations whose hashes
+// match are compared in full, and nullopt is returned when none up to steps
+// are equal: the hashes only collided.
+std::optional<size_t> loopStart(const Machine &machine, std::string_view input,
+                                size_t length, size_t steps);
+
+} // namespace turing::machine
@@ -6,15 +6,23 @@
 #include <iostream>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
 #include <vector>
 
+#include <unistd.h>
+
 #include "turing/log/log.hpp"
 #include "turing/machine/direction.h"
 #include "turing/machine/exception.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/loop.h"
+#include "turing/machine/observer.h"
+#include "turing/machine/stream.h"
 #include "turing/machine/tape.h"
+#include "turing/machine/trace.h"
 #include "turing/machine/transition.h"
 #include "turing/util/string.h"
 
@@ -26,12 +34,46 @@ Machine::Machine(
     std::unordered_set<char> tapeAlphabet, std::string startState,
     char blankSymbol, std::unordered_set<std::string> finalStates, size_t nTape,
     std::unordered_map<std::string, std::vector<Transition>> transitions)
-    : states_(states), inputAlphabet_(inputAlphabet),
-      tapeAlphabet_(tapeAlphabet), startState_(startState),
-      blankSymbol_(blankSymbol), finalStates_(finalStates), nTape_(nTape),
-      transitions_(transitions) {}
+    : states_(std::move(states)), inputAlphabet_(std::move(inputAlphabet)),
+      tapeAlphabet_(std::move(tapeAlphabet)),
+      startState_(std::move(startState)), blankSymbol_(blankSymbol),
+      finalStates_(std::move(finalStates)), nTape_(nTape),
+      transitions_(std::move(transitions)), inputMask_(inputAlphabet_) {
+  for (auto &[_, subTransition] : transitions_) {
+    for (Transition &transition : subTransition) {
+      transition.id = transitionTable_.size();
+      transitionTable_.push_back(&transition);
+    }
+  }
+
+  // walk the transitions backwards from the final states
+  std::unordered_map<std::string, std::vector<const std::string *>> sources;
+  for (const Transition *transition : transitionTable_) {
+    sources[transition->newState].push_back(&transition->oldState);
+  }
+  std::vector<const std::string *> pending;
+  for (const std::string &state : finalStates_) {
+    if (accepting_.insert(state).second) {
+      pending.push_back(&state);
+    }
+  }
+  while (!pending.empty()) {
+    const std::string &state = *pending.back();
+    pending.pop_back();
+    if (auto found = sources.find(state); found != sources.end()) {
+      for (const std::string *source : found->second) {
+        if (accepting_.insert(*source).second) {
+          pending.push_back(source);
+        }
+      }
+    }
+  }
+}
 
-void Machine::run(const std::string &input) {
+std::optional<RunResult> Machine::run(std::string_view input, bool detectLoops,
+                                      const TraceOption &trace,
+                                      const ObserveOption &observe,
+                                      bool keepContent) const {
   if (turing::log::isVerbose()) {
     turing::log::info("Input: ", input);
   }
@@ -53,7 +95,7 @@ void Machine::run(const std::string &input) {
     } else {
       turing::log::error("illegal input string");
     }
-    throw InvalidInputException(input);
+    throw InvalidInputException(std::string{input});
   }
 
   assert(std::holds_alternative<bool>(validResult));
@@ -63,57 +105,193 @@ void Machine::run(const std::string &input) {
     turing::log::info("==================== RUN ====================");
   }
 
-  Tapes tapes = Tapes{input, startState_, finalStates_, nTape_, blankSymbol_};
-  bool accepted = finalStates_.contains(tapes.currentState());
+  Execution execution{*this, input};
+  if (!this->trace(execution,
+                   detectLoops ? std::optional{input} : std::nullopt, trace,
+                   observe) ||
+      observe.decide) {
+    return std::nullopt;
+  }
 
+  const Tapes &tapes = execution.tapes();
+  return RunResult{
+      .accepted = tapes.isAccepted(),
+      .steps = tapes.steps(),
+      .content = keepContent ? tapes.content().value_or("") : std::string{},
+  };
+}
+
+void Machine::runStream(int fd, const TraceOption &trace,
+                        const ObserveOption &observe) const {
+  try {
+    StreamInput input{fd, inputMask_};
+
+    if (turing::log::isVerbose()) {
+      turing::log::info("==================== RUN ====================");
+    }
+
+    Execution execution{*this, input};
+    this->trace(execution, std::nullopt, trace, observe);
+  } catch (const InvalidSymbolException &e) {
+    if (turing::log::isVerbose()) {
+      turing::log::error("==================== ERR ====================");
+      turing::log::error(
+          "error: Symbol \"", e.symbol(),
+          "\" in input is not defined in the set of input symbols");
+      turing::log::error("Index: ", e.index());
+      turing::log::error("==================== END ====================");
+    } else {
+      turing::log::error("illegal input string");
+    }
+    throw;
+  }
+}
+
+bool Machine::trace(Execution &execution,
+                    std::optional<std::string_view> loopInput,
+                    const TraceOption &option,
+                    const ObserveOption &observe) const {
+  Tapes &tapes = execution.tapes();
+
+  std::optional<VerboseObserver> verbose;
   if (turing::log::isVerbose()) {
-    turing::log::info<false>(tapes.id());
+    verbose.emplace(*this, option, execution);
+  }
+  std::optional<ProfileObserver> profile;
+  if (observe.profile.has_value()) {
+    profile.emplace(*this, observe.profile.value());
+  }
+  std::optional<TraceFileObserver> traceFile;
+  if (observe.traceFile.has_value()) {
+    traceFile.emplace(observe.traceFile.value());
+  }
+  std::optional<DecideObserver> decider;
+  if (observe.decide) {
+    decider.emplace(*this, tapes);
+  }
+  std::optional<LoopObserver> detector;
+  if (loopInput.has_value()) {
+    detector.emplace(tapes);
   }
 
-  for (std::optional<Transition> transition =
-           determineTransition(tapes.currentView());
-       transition != std::nullopt;
-       transition = determineTransition(tapes.currentView())) {
-    tapes.step(transition.value());
+  // the verdict may be known in the start state already
+  auto decided = [&] { return decider.has_value() && decider->decided(); };
+  bool stopped = !decided() &&
+                 turing::machine::observe(execution, verbose, profile,
+                                          traceFile, decider, detector);
+
+  // only the decider and the loop detector stop a run early, and a verdict
+  // found on the same step as a loop wins. A loop is only reported once the
+  // replay finds two equal configurations; after a mere hash collision the
+  // run goes on, watched by a fresh detector.
+  std::optional<size_t> loopLength;
+  std::optional<size_t> loopBegin;
+  while (stopped && !decided()) {
+    size_t length = detector->length();
+    loopBegin = loopStart(*this, loopInput.value(), length, tapes.steps());
+    if (loopBegin.has_value()) {
+      loopLength = length;
+      break;
+    }
+    detector.emplace(tapes);
+    stopped = turing::machine::observe(execution, verbose, profile, traceFile,
+                                       decider, detector);
+  }
+
+  if (verbose.has_value()) {
+    verbose->finish();
+  }
+  if (profile.has_value()) {
+    profile->finish();
+  }
+  if (traceFile.has_value()) {
+    traceFile->finish();
+  }
+
+  if (loopLength.has_value()) {
+    size_t length = loopLength.value();
+    size_t start = loopBegin.value();
 
     if (turing::log::isVerbose()) {
-      turing::log::info<false>(tapes.id());
+      turing::log::info("LOOP");
+      turing::log::info("Cycle: ", length);
+      turing::log::info("Start: ", start);
+      turing::log::info("==================== END ====================");
+    } else {
+      turing::log::info("(LOOP)", " ", "cycle ", length, " from step ",
+                        start);
     }
+    return false;
   }
 
+  // the result is streamed to stdout straight from the tape, after
+  // everything logged before it
+  std::cout.flush();
+
   if (turing::log::isVerbose()) {
     if (tapes.isAccepted()) {
       turing::log::info("ACCEPTED");
     } else {
       turing::log::info("UNACCEPTED");
     }
-    auto content = tapes.content();
-    if (content.has_value()) {
-      turing::log::info("Result:", " ", content.value());
+    if (!decider.has_value()) {
+      tapes.writeContent(STDOUT_FILENO, "Result: ", "\n");
     }
     turing::log::info("==================== END ====================");
+  } else if (decider.has_value()) {
+    turing::log::info(tapes.isAccepted() ? "(ACCEPTED)" : "(UNACCEPTED)");
   } else {
-    if (tapes.isAccepted()) {
-      turing::log::info("(ACCEPTED)", " ", tapes.content().value_or(""));
-    } else {
-      turing::log::info("(UNACCEPTED)", " ", tapes.content().value_or(""));
+    const char *verdict = tapes.isAccepted() ? "(ACCEPTED) " : "(UNACCEPTED) ";
+    if (!tapes.writeContent(STDOUT_FILENO, verdict, "\n")) {
+      turing::log::info(verdict);
     }
   }
+
+  return true;
 }
 
-std::variant<bool, size_t> Machine::isInputValid(const std::string &input) {
-  auto it =
-      std::find_if_not(input.begin(), input.end(), [this](char ch) -> bool {
-        return inputAlphabet_.contains(ch);
-      });
-  if (it == input.end()) {
+std::variant<bool, size_t> Machine::isInputValid(std::string_view input) const {
+  size_t index = inputMask_.findFirstNotOf(input);
+  if (index == std::string_view::npos) {
     return true;
   } else {
-    return static_cast<size_t>(std::distance(input.begin(), it));
+    return index;
   }
 }
 
-std::string Machine::to_string() {
+size_t Machine::nTransition() const { return transitionTable_.size(); }
+
+const Transition &Machine::transition(size_t id) const {
+  return *transitionTable_[id];
+}
+
+const std::unordered_set<std::string> &Machine::states() const {
+  return states_;
+}
+
+const std::unordered_set<char> &Machine::inputAlphabet() const {
+  return inputAlphabet_;
+}
+
+const std::unordered_set<char> &Machine::tapeAlphabet() const {
+  return tapeAlphabet_;
+}
+
+const std::string &Machine::startState() const { return startState_; }
+
+char Machine::blankSymbol() const { return blankSymbol_; }
+
+const std::unordered_set<std::string> &Machine::finalStates() const {
+  return finalStates_;
+}
+
+size_t Machine::nTape() const { return nTape_; }
+
+bool Machine::canAccept(const std::string &state) const {
+  return accepting_.contains(state);
+}
+
+std::string Machine::to_string() const {
   std::string s;
 
   static std::function<std::string(std::unordered_set<std::string>)>
@@ -168,42 +346,43 @@ std::string Machine::to_string() {
   return s;
 }
 
-std::optional<Transition> Machine::determineTransition(const TapeView &view) {
-  if (!transitions_.contains(view.state)) {
-    return std::nullopt; // halt
+const Transition *Machine::determineTransition(const TapeView &view) const {
+  auto found = transitions_.find(view.state);
+  if (found == transitions_.end()) {
+    return nullptr; // halt
   }
 
-  std::vector<Transition> &transitions = transitions_[view.state];
+  const std::vector<Transition> &transitions = found->second;
 
   auto it = std::find_if(transitions.begin(), transitions.end(),
                          [&view](const Transition &transition) -> bool {
                            return view.signs == transition.oldSigns;
                          });
   if (it != transitions.end()) {
-    return *it;
+    return &*it;
   }
 
-  std::vector<Transition> candidates = transitions;
-
   if (!transitions.empty()) {
     assert(view.signs.size() == transitions[0].oldSigns.size());
   }
 
-  // handle '*' pattern
-  for (size_t i = 0; i < view.signs.size(); ++i) {
-    char sign = view.signs[i];
-    // FIXME !
-    std::erase_if(candidates, [sign, i](const Transition &transition) -> bool {
-      char tSign = transition.oldSigns[i];
-      return sign != tSign && turing::util::string::STAR != tSign;
-    });
-  }
-
-  if (candidates.empty()) {
-    return std::nullopt;
+  // handle '*' pattern, the first matching candidate wins
+  it = std::find_if(
+      transitions.begin(), transitions.end(),
+      [&view](const Transition &transition) -> bool {
+        for (size_t i = 0; i < view.signs.size(); ++i) {
+          char tSign = transition.oldSigns[i];
+          if (view.signs[i] != tSign && turing::util::string::STAR != tSign) {
+            return false;
+          }
+        }
+        return true;
+      });
+  if (it == transitions.end()) {
+    return nullptr;
   }
 
-  return candidates[0]; // assume only contains candidate transition
+  return &*it;
 }
 
 } // namespace turing::machine
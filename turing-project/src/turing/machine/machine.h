@@ -2,15 +2,31 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
 #include <vector>
 
+#include "turing/machine/alphabet.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/observer.h"
 #include "turing/machine/tape.h"
+#include "turing/machine/trace.h"
 #include "turing/machine/transition.h"
 
 namespace turing::machine {
+
+// how a run that halted ended
+struct RunResult {
+  bool accepted;
+  size_t steps;
+  std::string content; // non-blank range of tape 0, if asked for
+};
+
+// Immutable program compiled from a .tm file. Every member function is const
+// and never mutates the containers, so one instance can be shared by any
+// number of threads; per-run state lives in Execution.
 class Machine {
 public:
   Machine(
@@ -20,11 +36,43 @@ public:
       char blankSymbol, std::unordered_set<std::string> finalStates,
       size_t nTape,
       std::unordered_map<std::string, std::vector<Transition>> transitions);
+  // transitions are referred to by address, which a copy would not keep
+  Machine(const Machine &) = delete;
+  Machine(Machine &&) = default;
+
+  // with detectLoops, a run that repeats a configuration stops with a
+  // (LOOP) verdict instead of running forever. A verbose run prints the
+  // steps selected by trace. With observe.decide, the run stops as soon as
+  // its verdict is known and prints no result. Return the result unless a
+  // loop was found or the run only decided. The result is streamed to stdout,
+  // so it is only copied into RunResult::content with keepContent.
+  std::optional<RunResult> run(std::string_view input, bool detectLoops = false,
+                               const TraceOption &trace = {},
+                               const ObserveOption &observe = {},
+                               bool keepContent = false) const;
+  // run on the input read from fd, loading it only as the head reaches it
+  void runStream(int fd, const TraceOption &trace = {},
+                 const ObserveOption &observe = {}) const;
 
-  void run(const std::string &input);
+  std::variant<bool, size_t> isInputValid(std::string_view input) const;
+  const Transition *determineTransition(const TapeView &view) const;
+  // transitions are numbered by Transition::id in [0, nTransition())
+  size_t nTransition() const;
+  const Transition &transition(size_t id) const;
+  const std::unordered_set<std::string> &states() const;
+
+  const std::unordered_set<char> &inputAlphabet() const;
+  const std::unordered_set<char> &tapeAlphabet() const;
+  const std::string &startState() const;
+  char blankSymbol() const;
+  const std::unordered_set<std::string> &finalStates() const;
+  size_t nTape() const;
+  // whether some path of transitions leads from state to a final state,
+  // whatever the tapes hold. A run in a state that cannot accept never will.
+  bool canAccept(const std::string &state) const;
 
   // helper method
-  std::string to_string();
+  std::string to_string() const;
 
 private:
   std::unordered_set<std::string> states_;      // 状态集    Q
@@ -36,7 +84,14 @@ private:
   size_t nTape_;                                // 纸带数     N
   std::unordered_map<std::string, std::vector<Transition>> transitions_; // 状态函数 delta
 
-  std::variant<bool, size_t> isInputValid(const std::string &input);
-  std::optional<Transition> determineTransition(const TapeView &view);
+  Alphabet inputMask_;
+  std::vector<const Transition *> transitionTable_;
+  std::unordered_set<std::string> accepting_; // states that can accept
+
+  // loopInput is the input execution started from, when detecting loops
+  // return false when a loop stopped the run
+  bool trace(Execution &execution, std::optional<std::string_view> loopInput,
+             const TraceOption &option, const ObserveOption &observe) const;
 };
+
 } // namespace turing::machine
@@ -0,0 +1,163 @@
+#include "turing/machine/observer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "turing/log/log.hpp"
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/trace.h"
+#include "turing/machine/transition.h"
+
+namespace turing::machine {
+
+namespace {
+constexpr size_t TRACE_BUFFER = 1 << 16;
+
+// transition as the statement of a .tm file
+void writeStatement(std::ostream &out, const Transition &transition) {
+  out << transition.oldState << ' ';
+  out.write(transition.oldSigns.data(),
+            static_cast<std::streamsize>(transition.oldSigns.size()));
+  out << ' ';
+  out.write(transition.newSigns.data(),
+            static_cast<std::streamsize>(transition.newSigns.size()));
+  out << ' ';
+  for (Direction direction : transition.directions) {
+    out << to_string(direction);
+  }
+  out << ' ' << transition.newState;
+}
+} // namespace
+
+std::string statementOf(const Transition &transition) {
+  std::ostringstream out;
+  writeStatement(out, transition);
+  return out.str();
+}
+
+VerboseObserver::VerboseObserver(const Machine &machine,
+                                 const TraceOption &option,
+                                 Execution &execution)
+    : filter_(machine, option), last_(option.last), execution_(execution),
+      selected_(false) {
+  // with last, selected steps are only remembered and printed at halt
+  if (last_ > 0) {
+    execution_.journal();
+  }
+  if (filter_.selectStart()) {
+    select();
+  }
+}
+
+void VerboseObserver::select() {
+  Tapes &tapes = execution_.tapes();
+  if (last_ == 0) {
+    turing::log::info<false>(tapes.id());
+    return;
+  }
+  kept_.push_back(tapes.steps());
+  if (kept_.size() > last_) {
+    kept_.pop_front();
+  }
+}
+
+// go back through the journal to the first kept step and replay up to the
+// current one, printing the kept steps
+void VerboseObserver::finish() {
+  if (kept_.empty()) {
+    return;
+  }
+
+  Tapes &tapes = execution_.tapes();
+  size_t end = tapes.steps();
+
+  if (!execution_.seek(kept_.front())) {
+    turing::log::info("... steps before ", tapes.steps(),
+                      " are no longer journaled");
+  }
+
+  auto it = std::lower_bound(kept_.begin(), kept_.end(), tapes.steps());
+  while (true) {
+    if (it != kept_.end() && *it == tapes.steps()) {
+      turing::log::info<false>(tapes.id());
+      ++it;
+    }
+    if (tapes.steps() == end) {
+      break;
+    }
+    execution_.step();
+  }
+}
+
+LoopObserver::LoopObserver(Tapes &tapes)
+    : detector_((tapes.trackHash(), tapes.hash())) {}
+
+DecideObserver::DecideObserver(const Machine &machine, const Tapes &tapes)
+    : decides_(machine.nTransition()),
+      decided_(tapes.isAccepted() || !machine.canAccept(tapes.currentState())) {
+  for (size_t id = 0; id < decides_.size(); ++id) {
+    const std::string &state = machine.transition(id).newState;
+    decides_[id] =
+        machine.finalStates().contains(state) || !machine.canAccept(state);
+  }
+}
+
+ProfileObserver::ProfileObserver(const Machine &machine,
+                                 const std::string &path)
+    : machine_(machine), path_(path), out_(path),
+      hits_(machine.nTransition(), 0) {
+  if (!out_) {
+    throw std::invalid_argument("cannot write " + path);
+  }
+}
+
+const std::vector<uint64_t> &ProfileObserver::hits() const { return hits_; }
+
+void ProfileObserver::finish() {
+  for (size_t id = 0; id < hits_.size() && out_; ++id) {
+    out_ << hits_[id] << ' ';
+    writeStatement(out_, machine_.transition(id));
+    out_ << '\n';
+  }
+  if (!out_.flush()) {
+    throw std::invalid_argument("cannot write " + path_);
+  }
+}
+
+TraceFileObserver::TraceFileObserver(const std::string &path)
+    : path_(path), buffer_(TRACE_BUFFER) {
+  // a file buffer can only be set before the file is opened
+  out_.rdbuf()->pubsetbuf(buffer_.data(),
+                          static_cast<std::streamsize>(buffer_.size()));
+  out_.open(path);
+  if (!out_) {
+    throw std::invalid_argument("cannot write " + path);
+  }
+}
+
+bool TraceFileObserver::after(const Transition &fired,
+                              const Execution &execution) {
+  out_ << execution.tapes().steps() << ' ';
+  writeStatement(out_, fired);
+  out_ << '\n';
+  return false;
+}
+
+void TraceFileObserver::finish() {
+  if (!out_.flush()) {
+    throw std::invalid_argument("cannot write " + path_);
+  }
+}
+
+} // namespace turing::machine
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/loop.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/trace.h"
+#include "turing/machine/transition.h"
+
+namespace turing::machine {
+
+class Machine;
+
+// Instrumentation of a run besides verbose output, all off by default
+struct ObserveOption {
+  std::optional<std::string> profile;   // file to write transition hits to
+  std::optional<std::string> traceFile; // file to write fired transitions to
+  bool decide = false; // stop once the verdict is known, see DecideObserver
+
+  bool operator==(const ObserveOption &other) const = default;
+};
+
+// transition as the statement of a .tm file, the way observers write it
+std::string statementOf(const Transition &transition);
+
+// An observer watches the steps of a run:
+//
+//   void before(const Transition &fired, const Tapes &tapes);
+//   bool after(const Transition &fired, const Execution &execution);
+//
+// before is called with the configuration fired applies to, after once it
+// has been applied, and returning true from after stops the run. Observers
+// are template arguments of observe, so the loop of a run without any is
+// the bare step loop.
+
+// steps a verbose run prints, selected by a TraceFilter
+class VerboseObserver {
+public:
+  // throw std::invalid_argument for unknown states or tapes in option
+  VerboseObserver(const Machine &machine, const TraceOption &option,
+                  Execution &execution);
+
+  void before(const Transition &fired, const Tapes &tapes) {
+    // decided before the step, the filter looks at the cells it overwrites
+    selected_ = filter_.select(fired, tapes);
+  }
+  bool after(const Transition &, const Execution &) {
+    if (selected_) {
+      select();
+    }
+    return false;
+  }
+
+  // print the steps kept for option.last, once the run stopped
+  void finish();
+
+private:
+  TraceFilter filter_;
+  size_t last_;
+  Execution &execution_;
+  std::deque<size_t> kept_;
+  bool selected_;
+
+  void select();
+};
+
+// stops a run that repeats a configuration
+class LoopObserver {
+public:
+  explicit LoopObserver(Tapes &tapes);
+
+  void before(const Transition &, const Tapes &) {}
+  bool after(const Transition &, const Execution &execution) {
+    return detector_.observe(execution.tapes().hash());
+  }
+
+  // length of the cycle, once after returned true
+  size_t length() const { return detector_.length(); }
+
+private:
+  LoopDetector detector_;
+};
+
+// Stops a run as soon as its verdict is known: when it first enters a
+// final state, which accepts whatever follows, or a state from which no
+// final state can be reached, which rejects. Whether a transition decides
+// is looked up once per machine, so a step costs one table read.
+class DecideObserver {
+public:
+  DecideObserver(const Machine &machine, const Tapes &tapes);
+
+  void before(const Transition &, const Tapes &) {}
+  bool after(const Transition &fired, const Execution &) {
+    decided_ = decides_[fired.id];
+    return decided_;
+  }
+
+  // whether the verdict was known before the machine halted, possibly in
+  // the start state. Tapes::isAccepted is the verdict either way.
+  bool decided() const { return decided_; }
+
+private:
+  std::vector<char> decides_; // by Transition::id
+  bool decided_;
+};
+
+// counts how often every transition fires
+class ProfileObserver {
+public:
+  // throw std::invalid_argument when path cannot be written
+  ProfileObserver(const Machine &machine, const std::string &path);
+
+  void before(const Transition &fired, const Tapes &) { ++hits_[fired.id]; }
+  bool after(const Transition &, const Execution &) { return false; }
+
+  // by Transition::id
+  const std::vector<uint64_t> &hits() const;
+  // Write one line per transition, "<hits> <statement>", in the order of
+  // Transition::id. Throw std::invalid_argument when that fails.
+  void finish();
+
+private:
+  const Machine &machine_;
+  std::string path_;
+  std::ofstream out_;
+  std::vector<uint64_t> hits_;
+};
+
+// writes "<step> <statement>" for every fired transition
+class TraceFileObserver {
+public:
+  // throw std::invalid_argument when path cannot be written
+  explicit TraceFileObserver(const std::string &path);
+
+  void before(const Transition &, const Tapes &) {}
+  bool after(const Transition &fired, const Execution &execution);
+
+  // throw std::invalid_argument when the trace could not be written
+  void finish();
+
+private:
+  std::string path_;
+  std::vector<char> buffer_; // outlives out_, which flushes into it
+  std::ofstream out_;
+};
+
+// the observers of one run, called in order
+template <typename... Observers> class ObserverList {
+public:
+  explicit ObserverList(Observers &...observers) : observers_(observers...) {}
+
+  void before(const Transition &fired, const Tapes &tapes) {
+    std::apply([&](auto &...o) { (o.before(fired, tapes), ...); }, observers_);
+  }
+  // every observer sees the step, even when an earlier one stops the run
+  bool after(const Transition &fired, const Execution &execution) {
+    bool stop = false;
+    std::apply(
+        [&](auto &...o) { ((stop = o.after(fired, execution) || stop), ...); },
+        observers_);
+    return stop;
+  }
+
+private:
+  std::tuple<Observers &...> observers_;
+};
+
+// run execution until it halts or an observer stops it, return whether an
+// observer did
+template <typename Observer>
+bool runObserved(Execution &execution, Observer &observer) {
+  while (const Transition *fired = execution.next()) {
+    observer.before(*fired, execution.tapes());
+    execution.step();
+    if (observer.after(*fired, execution)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace detail {
+template <typename... Chosen>
+bool observe(Execution &execution, std::tuple<Chosen &...> chosen) {
+  ObserverList<Chosen...> observers =
+      std::make_from_tuple<ObserverList<Chosen...>>(chosen);
+  return runObserved(execution, observers);
+}
+
+template <typename... Chosen, typename Next, typename... Rest>
+bool observe(Execution &execution, std::tuple<Chosen &...> chosen,
+             std::optional<Next> &next, std::optional<Rest> &...rest) {
+  if (next.has_value()) {
+    return observe(execution, std::tuple_cat(chosen, std::tie(next.value())),
+                   rest...);
+  }
+  return observe(execution, chosen, rest...);
+}
+} // namespace detail
+
+// Run execution under the observers that are set, in the order given. The
+// set is looked at once, and the loop instantiated for exactly those
+// observers runs the steps. Return whether an observer stopped the run.
+template <typename... Observers>
+bool observe(Execution &execution, std::optional<Observers> &...observers) {
+  return detail::observe(execution, std::tuple<>{}, observers...);
+}
+
+} // namespace turing::machine
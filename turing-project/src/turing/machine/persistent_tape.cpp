@@ -0,0 +1,312 @@
+#include "turing/machine/persistent_tape.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+#include "turing/util/string.h"
+
+namespace turing::machine {
+
+PersistentTape::PersistentTape(std::string_view input, char blank)
+    : head_(0), blank_(blank), low_(0), high_(-1), cache_(nullptr),
+      cacheLow_(1), cacheHigh_(0), owned_(nullptr), path_{}, pathLength_(0),
+      leaf_(nullptr) {
+  for (size_t i = 0; i < input.size(); ++i) {
+    write(static_cast<int>(i), input[i]);
+  }
+  cache(head_, find(head_));
+}
+
+// Both now share every node, so the next write of either copies: other
+// sees the use count of its root go up.
+PersistentTape::PersistentTape(const PersistentTape &other)
+    : right_(other.right_), left_(other.left_), head_(other.head_),
+      blank_(other.blank_), low_(other.low_), high_(other.high_),
+      cache_(other.cache_), cacheLow_(other.cacheLow_),
+      cacheHigh_(other.cacheHigh_), owned_(nullptr), path_{}, pathLength_(0),
+      leaf_(nullptr) {}
+
+PersistentTape &PersistentTape::operator=(const PersistentTape &other) {
+  if (this != &other) {
+    *this = PersistentTape{other};
+  }
+  return *this;
+}
+
+// path_ points into the trees of other, so ownership is not carried over
+PersistentTape::PersistentTape(PersistentTape &&other) noexcept
+    : right_(std::move(other.right_)), left_(std::move(other.left_)),
+      head_(other.head_), blank_(other.blank_), low_(other.low_),
+      high_(other.high_), cache_(other.cache_), cacheLow_(other.cacheLow_),
+      cacheHigh_(other.cacheHigh_), owned_(nullptr), path_{}, pathLength_(0),
+      leaf_(nullptr) {
+  other.owned_ = nullptr;
+}
+
+PersistentTape &PersistentTape::operator=(PersistentTape &&other) noexcept {
+  if (this != &other) {
+    right_ = std::move(other.right_);
+    left_ = std::move(other.left_);
+    head_ = other.head_;
+    blank_ = other.blank_;
+    low_ = other.low_;
+    high_ = other.high_;
+    cache_ = other.cache_;
+    cacheLow_ = other.cacheLow_;
+    cacheHigh_ = other.cacheHigh_;
+    owned_ = nullptr;
+    other.owned_ = nullptr;
+  }
+  return *this;
+}
+
+void PersistentTape::move(const Direction &direction, char newSign) {
+  // rewriting a cell with its own symbol must not unshare its chunk
+  if (newSign != turing::util::string::STAR &&
+      newSign != cache_[offset(head_)]) {
+    write(head_, newSign);
+  }
+
+  switch (direction) {
+  case Direction::LEFT:
+    --head_;
+    break;
+  case Direction::RIGHT:
+    ++head_;
+    break;
+  case Direction::STAY:
+    break;
+  default:
+    throw std::exception();
+  }
+
+  if (!inCache(head_)) {
+    cache(head_, find(head_));
+  }
+}
+
+char PersistentTape::cellAt(int index) const {
+  const Chunk *chunk = find(index);
+  return chunk != nullptr ? chunk->cells[offset(index)] : blank_;
+}
+
+std::optional<std::string> PersistentTape::contentString() const {
+  int low = low_;
+  int high = high_;
+  while (low <= high && cellAt(low) == blank_) {
+    ++low;
+  }
+  while (high >= low && cellAt(high) == blank_) {
+    --high;
+  }
+  if (low > high) {
+    return std::nullopt;
+  }
+
+  std::string s;
+  s.reserve(static_cast<size_t>(high - low + 1));
+  const char *cells = nullptr;
+  int first = 1;
+  int last = 0;
+  for (int i = low; i <= high; ++i) {
+    if (i < first || i > last) {
+      const Chunk *chunk = find(i);
+      cells = (chunk != nullptr ? chunk : &blankChunk(blank_))->cells.data();
+      chunkRange(i, first, last);
+    }
+    s.push_back(cells[offset(i)]);
+  }
+  return s;
+}
+
+bool PersistentTape::shares(const PersistentTape &other, int index) const {
+  const Chunk *chunk = find(index);
+  return chunk != nullptr && chunk == other.find(index);
+}
+
+const PersistentTape::Chunk &PersistentTape::blankChunk(char blank) {
+  static const std::array<Chunk, 256> CHUNKS = []() {
+    std::array<Chunk, 256> chunks;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      chunks[i].cells.fill(static_cast<char>(i));
+    }
+    return chunks;
+  }();
+  return CHUNKS[static_cast<unsigned char>(blank)];
+}
+
+const PersistentTape::Chunk *PersistentTape::find(int index) const {
+  const Tree &tree = index >= 0 ? right_ : left_;
+  size_t chunk = positionOf(index) >> CHUNK_BITS;
+  if ((chunk >> (FANOUT_BITS * tree.depth)) != 0) {
+    return nullptr;
+  }
+
+  const Node *node = tree.root.get();
+  for (size_t level = tree.depth; level > 1 && node != nullptr; --level) {
+    node = node->nodes[(chunk >> (FANOUT_BITS * (level - 1))) & (FANOUT - 1)]
+               .get();
+  }
+  return node != nullptr ? node->chunks[chunk & (FANOUT - 1)].get() : nullptr;
+}
+
+void PersistentTape::chunkRange(int index, int &first, int &last) {
+  int low = static_cast<int>(positionOf(index) >> CHUNK_BITS << CHUNK_BITS);
+  int high = low + static_cast<int>(CHUNK) - 1;
+  if (index >= 0) {
+    first = low;
+    last = high;
+  } else {
+    first = -1 - high;
+    last = -1 - low;
+  }
+}
+
+std::shared_ptr<PersistentTape::Chunk> &PersistentTape::own(int index) {
+  Tree &tree = index >= 0 ? right_ : left_;
+  size_t chunk = positionOf(index) >> CHUNK_BITS;
+
+  // add levels on top until the tree reaches chunk
+  while ((chunk >> (FANOUT_BITS * tree.depth)) != 0) {
+    if (tree.root != nullptr) {
+      auto root = std::make_shared<Node>();
+      root->nodes[0] = std::move(tree.root);
+      tree.root = std::move(root);
+    }
+    ++tree.depth;
+  }
+
+  // a copied node shares its children, which are then copied in turn
+  auto ownNode = [](std::shared_ptr<Node> &node) {
+    if (node == nullptr) {
+      node = std::make_shared<Node>();
+    } else if (node.use_count() > 1) {
+      node = std::make_shared<Node>(*node);
+    }
+  };
+
+  assert(tree.depth <= MAX_DEPTH);
+  pathLength_ = 0;
+  std::shared_ptr<Node> *node = &tree.root;
+  for (size_t level = tree.depth; level > 1; --level) {
+    ownNode(*node);
+    path_[pathLength_++] = node;
+    node = &(*node)->nodes[(chunk >> (FANOUT_BITS * (level - 1))) &
+                           (FANOUT - 1)];
+  }
+  ownNode(*node);
+  path_[pathLength_++] = node;
+
+  std::shared_ptr<Chunk> &leaf = (*node)->chunks[chunk & (FANOUT - 1)];
+  if (leaf == nullptr) {
+    leaf = std::make_shared<Chunk>(blankChunk(blank_));
+  } else if (leaf.use_count() > 1) {
+    leaf = std::make_shared<Chunk>(*leaf);
+  }
+  return leaf;
+}
+
+// The slots stay valid while this tape does not write elsewhere: another
+// copy only replaces slots of nodes it alone holds, and those are not ours.
+bool PersistentTape::isShared() const {
+  for (size_t i = 0; i < pathLength_; ++i) {
+    if (path_[i]->use_count() > 1) {
+      return true;
+    }
+  }
+  return leaf_->use_count() > 1;
+}
+
+void PersistentTape::cache(int index, const Chunk *chunk) {
+  cache_ = (chunk != nullptr ? chunk : &blankChunk(blank_))->cells.data();
+  owned_ = nullptr;
+  chunkRange(index, cacheLow_, cacheHigh_);
+}
+
+void PersistentTape::write(int index, char sign) {
+  if (owned_ == nullptr || !inCache(index) || isShared()) {
+    std::shared_ptr<Chunk> &leaf = own(index);
+    cache(index, leaf.get());
+    owned_ = leaf->cells.data();
+    leaf_ = &leaf;
+  }
+  owned_[offset(index)] = sign;
+
+  if (sign != blank_) {
+    low_ = low_ > high_ ? index : std::min(low_, index);
+    high_ = std::max(high_, index);
+  }
+}
+
+PersistentTapes::PersistentTapes(const Machine &machine, std::string_view input)
+    : machine_(&machine), state_(machine.startState()), step_(0),
+      accepted_(machine.finalStates().contains(state_)), next_(nullptr) {
+  tapes_.reserve(machine.nTape());
+  tapes_.emplace_back(input, machine.blankSymbol());
+  for (size_t i = 1; i < machine.nTape(); ++i) {
+    tapes_.emplace_back(std::string_view{}, machine.blankSymbol());
+  }
+  next_ = pick();
+}
+
+const Transition *PersistentTapes::next() const { return next_; }
+
+bool PersistentTapes::step() {
+  if (next_ == nullptr) {
+    return false;
+  }
+  step(*next_);
+  return true;
+}
+
+void PersistentTapes::step(const Transition &transition) {
+  assert(transition.newSigns.size() == tapes_.size());
+  for (size_t i = 0; i < tapes_.size(); ++i) {
+    tapes_[i].move(transition.directions[i], transition.newSigns[i]);
+  }
+
+  state_ = transition.newState;
+  ++step_;
+  accepted_ = accepted_ || machine_->finalStates().contains(state_);
+  next_ = pick();
+}
+
+const std::string &PersistentTapes::currentState() const { return state_; }
+
+size_t PersistentTapes::steps() const { return step_; }
+
+bool PersistentTapes::isAccepted() const { return accepted_; }
+
+const PersistentTape &PersistentTapes::tape(size_t tape) const {
+  return tapes_[tape];
+}
+
+void PersistentTapes::currentSigns(char *signs) const {
+  for (const PersistentTape &tape : tapes_) {
+    *signs++ = tape.currentSign();
+  }
+}
+
+std::optional<std::string> PersistentTapes::content() const {
+  return tapes_[0].contentString();
+}
+
+const Transition *PersistentTapes::pick() const {
+  TapeView view{.state = state_, .signs = std::vector<char>(tapes_.size())};
+  currentSigns(view.signs.data());
+  return machine_->determineTransition(view);
+}
+
+} // namespace turing::machine
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/transition.h"
+
+namespace turing::machine {
+
+class Machine;
+
+// Tape kept in a persistent radix tree of fixed-size chunks, one tree for
+// the cells right of 0 and one for those left of it. Copies share every
+// node and cost O(1). A write copies the chunk it lands in, and the nodes
+// above that chunk, only while they are shared with another copy. Chunks
+// no write reached are not allocated and read as blank. Copying and the
+// other const members only read the tape, so one tape can be copied from
+// several threads at once.
+class PersistentTape {
+public:
+  static constexpr size_t CHUNK_BITS = 6;  // 64 cells per chunk
+  static constexpr size_t FANOUT_BITS = 5; // 32 children per inner node
+
+  PersistentTape(std::string_view input, char blank);
+
+  // O(1), the copies share their chunks until either writes
+  PersistentTape(const PersistentTape &other);
+  PersistentTape &operator=(const PersistentTape &other);
+  PersistentTape(PersistentTape &&other) noexcept;
+  PersistentTape &operator=(PersistentTape &&other) noexcept;
+
+  char currentSign() const { return cache_[offset(head_)]; }
+  int head() const { return head_; }
+  // write newSign under the head, '*' keeps the cell, then move like
+  // Tape::move
+  void move(const Direction &direction, char newSign);
+
+  char cellAt(int index) const;
+  // non-blank range
+  std::optional<std::string> contentString() const;
+  // whether cell index is stored in the same chunk as in other
+  bool shares(const PersistentTape &other, int index) const;
+
+private:
+  static constexpr size_t CHUNK = size_t{1} << CHUNK_BITS;
+  static constexpr size_t FANOUT = size_t{1} << FANOUT_BITS;
+  // levels of nodes that int cell indexes can need
+  static constexpr size_t MAX_DEPTH =
+      (31 - CHUNK_BITS + FANOUT_BITS - 1) / FANOUT_BITS;
+
+  struct Chunk {
+    std::array<char, CHUNK> cells;
+  };
+  // nodes of the lowest level hold chunks, the others hold nodes
+  struct Node {
+    std::array<std::shared_ptr<Node>, FANOUT> nodes;
+    std::array<std::shared_ptr<Chunk>, FANOUT> chunks;
+  };
+  struct Tree {
+    std::shared_ptr<Node> root; // null while every cell is blank
+    size_t depth = 1;           // levels of nodes, FANOUT^depth chunks
+  };
+
+  Tree right_; // cells 0, 1, 2, ...
+  Tree left_;  // cells -1, -2, -3, ...
+  int head_;
+  char blank_;
+
+  // every non-blank cell lies in [low_, high_] (empty when low_ > high_).
+  // Blanks written at its ends are skipped by contentString().
+  int low_;
+  int high_;
+
+  // Chunk of the cell last reached, so that stepping inside a chunk walks
+  // no tree: cells [cacheLow_, cacheHigh_] are cache_. The head is always
+  // inside the cached chunk.
+  const char *cache_;
+  int cacheLow_;
+  int cacheHigh_;
+  // Once this tape wrote to the cached chunk, owned_ is cache_ and path_
+  // and leaf_ are the slots holding the nodes above it and the chunk. A
+  // copy of either tape bumps their use counts instead of touching the
+  // source, so a write may go straight to owned_ while no slot is shared.
+  char *owned_;
+  std::array<const std::shared_ptr<Node> *, MAX_DEPTH> path_;
+  size_t pathLength_;
+  const std::shared_ptr<Chunk> *leaf_;
+
+  static const Chunk &blankChunk(char blank);
+
+  // position of cell index in its tree
+  static size_t positionOf(int index) {
+    return index >= 0 ? static_cast<size_t>(index)
+                      : static_cast<size_t>(-1 - index);
+  }
+  static size_t offset(int index) { return positionOf(index) & (CHUNK - 1); }
+  // first and last cell of the chunk of cell index
+  static void chunkRange(int index, int &first, int &last);
+  bool inCache(int index) const {
+    return cacheLow_ <= index && index <= cacheHigh_;
+  }
+
+  const Chunk *find(int index) const;
+  // Slot of the chunk of cell index, whose chunk and nodes above are copied
+  // or allocated until this tape alone holds them. The slots on the way
+  // are recorded in path_.
+  std::shared_ptr<Chunk> &own(int index);
+  // whether another copy holds owned_ or a node above it
+  bool isShared() const;
+  void cache(int index, const Chunk *chunk);
+  void write(int index, char sign);
+};
+
+// Configuration of a run on persistent tapes: state, step count, verdict
+// and tapes. A copy costs O(nTape), so configurations can be kept as
+// snapshots or forked into branches that step on independently.
+class PersistentTapes {
+public:
+  PersistentTapes(const Machine &machine, std::string_view input);
+
+  // transition fired by the next step, null once halted
+  const Transition *next() const;
+  // apply the next transition, return false once the machine halts
+  bool step();
+  // apply transition, which the machine need not pick itself
+  void step(const Transition &transition);
+
+  const std::string &currentState() const;
+  size_t steps() const;
+  bool isAccepted() const;
+  const PersistentTape &tape(size_t tape) const;
+  // write the symbol under every head into signs
+  void currentSigns(char *signs) const;
+  // non-blank range of tape 0
+  std::optional<std::string> content() const;
+
+private:
+  const Machine *machine_;
+  std::vector<PersistentTape> tapes_;
+  std::string state_;
+  size_t step_;
+  bool accepted_;
+  const Transition *next_;
+
+  const Transition *pick() const;
+};
+
+} // namespace turing::machine
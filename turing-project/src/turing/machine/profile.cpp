@@ -0,0 +1,99 @@
+#include "turing/machine/profile.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "turing/machine/machine.h"
+#include "turing/machine/observer.h"
+#include "turing/machine/transition.h"
+#include "turing/util/string.h"
+
+namespace turing::machine {
+
+Profile::Profile(const Machine &machine, const std::string &path)
+    : hits_(machine.nTransition(), 0) {
+  std::ifstream in{path};
+  if (!in) {
+    throw std::invalid_argument("cannot read " + path);
+  }
+
+  std::unordered_map<std::string, size_t> ids;
+  for (size_t id = machine.nTransition(); id-- > 0;) {
+    // identical statements never fire after the first one
+    ids[statementOf(machine.transition(id))] = id;
+  }
+
+  for (std::string line; std::getline(in, line);) {
+    if (line.empty()) {
+      continue;
+    }
+    size_t space = line.find(' ');
+    uint64_t hits = turing::util::string::to_size_t(line.substr(0, space));
+    auto found = space == std::string::npos ? ids.end()
+                                            : ids.find(line.substr(space + 1));
+    if (hits == SIZE_MAX || found == ids.end()) {
+      throw std::invalid_argument("profile " + path +
+                                  " does not match the machine: " + line);
+    }
+    hits_[found->second] += hits;
+  }
+}
+
+uint64_t Profile::hits(size_t id) const { return hits_[id]; }
+
+std::vector<size_t>::iterator orderTransitions(const Machine &machine,
+                                               const Profile *profile,
+                                               std::vector<size_t> &ids) {
+  auto patterns = std::stable_partition(
+      ids.begin(), ids.end(), [&machine](size_t id) {
+        const std::vector<char> &signs = machine.transition(id).oldSigns;
+        return std::find(signs.begin(), signs.end(),
+                         turing::util::string::STAR) == signs.end();
+      });
+  if (profile == nullptr) {
+    return patterns;
+  }
+
+  // only the first of the exact transitions reading the same symbols can
+  // fire, the others take its hits to stay behind it
+  std::map<std::vector<char>, uint64_t> heat;
+  for (auto it = ids.begin(); it != patterns; ++it) {
+    heat.try_emplace(machine.transition(*it).oldSigns, profile->hits(*it));
+  }
+  std::stable_sort(ids.begin(), patterns, [&](size_t a, size_t b) {
+    return heat[machine.transition(a).oldSigns] >
+           heat[machine.transition(b).oldSigns];
+  });
+  return patterns;
+}
+
+Machine reorder(const Machine &machine, const Profile &profile) {
+  // ids of a state are consecutive and in the order of its vector
+  std::unordered_map<std::string, std::vector<size_t>> owned;
+  for (size_t id = 0; id < machine.nTransition(); ++id) {
+    owned[machine.transition(id).oldState].push_back(id);
+  }
+
+  std::unordered_map<std::string, std::vector<Transition>> transitions;
+  for (auto &[state, ids] : owned) {
+    orderTransitions(machine, &profile, ids);
+    std::vector<Transition> &reordered = transitions[state];
+    for (size_t id : ids) {
+      reordered.push_back(machine.transition(id));
+    }
+  }
+
+  return Machine{machine.states(),       machine.inputAlphabet(),
+                 machine.tapeAlphabet(), machine.startState(),
+                 machine.blankSymbol(),  machine.finalStates(),
+                 machine.nTape(),        std::move(transitions)};
+}
+
+} // namespace turing::machine
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace turing::machine {
+
+class Machine;
+
+// Transition hit counts read back from a file written by --profile, see
+// ProfileObserver. Transitions are matched by their statement, so the
+// profile stays valid while the statements of the .tm file are moved
+// around.
+class Profile {
+public:
+  // throw std::invalid_argument when path cannot be read or has a line
+  // naming no transition of machine
+  Profile(const Machine &machine, const std::string &path);
+
+  // hits of transition id, 0 for transitions the profile does not list
+  uint64_t hits(size_t id) const;
+
+private:
+  std::vector<uint64_t> hits_; // by Transition::id
+};
+
+// Order ids, the transitions of one state in Machine order, so that the
+// first one matching is still the one Machine::determineTransition picks:
+// exact transitions first, the most frequent in profile (if any) first, then
+// '*' patterns in their own order. Return where the patterns begin.
+std::vector<size_t>::iterator orderTransitions(const Machine &machine,
+                                               const Profile *profile,
+                                               std::vector<size_t> &ids);
+
+// machine with the transitions of every state ordered by orderTransitions,
+// which behaves exactly like machine
+Machine reorder(const Machine &machine, const Profile &profile);
+
+} // namespace turing::machine
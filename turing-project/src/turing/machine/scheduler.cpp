@@ -0,0 +1,93 @@
+#include "turing/machine/scheduler.h"
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "turing/machine/execution.h"
+
+namespace turing::machine {
+
+Scheduler::Scheduler(size_t nThread, size_t slice)
+    : slice_(slice), pending_(0), stopping_(false) {
+  for (size_t i = 0; i < nThread; ++i) {
+    workers_.emplace_back([this]() { work(); });
+  }
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+void Scheduler::submit(std::unique_ptr<Execution> execution, Callback done,
+                       size_t maxSteps) {
+  auto job = std::make_unique<Job>();
+  job->steps = execution->steps(slice_, maxSteps);
+  job->execution = std::move(execution);
+  job->done = std::move(done);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++pending_;
+    queue_.push_back(std::move(job));
+  }
+  ready_.notify_one();
+}
+
+void Scheduler::work() {
+  while (true) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this]() {
+        return !queue_.empty() || (stopping_ && pending_ == 0);
+      });
+      if (queue_.empty()) {
+        ready_.notify_all();
+        return;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    // one slice, the generator finishes after the final configuration
+    std::exception_ptr error;
+    bool finished = false;
+    try {
+      finished = !job->steps.next() || job->execution->isHalted();
+    } catch (...) {
+      error = std::current_exception();
+      finished = true;
+    }
+
+    if (!finished) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(job));
+      }
+      ready_.notify_one();
+      continue;
+    }
+
+    job->steps = {};
+    job->done(std::move(job->execution), error);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pending_;
+    }
+    ready_.notify_all();
+  }
+}
+
+} // namespace turing::machine
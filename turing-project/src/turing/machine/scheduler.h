@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/tape.h"
+#include "turing/util/generator.hpp"
+
+namespace turing::machine {
+
+// Cooperative scheduler time-slicing many executions over a few threads.
+// A worker resumes a job for one slice of steps and then puts it back at the
+// end of the queue, so short runs are not stuck behind long ones.
+class Scheduler {
+public:
+  // called on a worker thread once the execution halts or exhausts its step
+  // budget; error is set if stepping threw
+  using Callback = std::function<void(std::unique_ptr<Execution> execution,
+                                      std::exception_ptr error)>;
+
+  Scheduler(size_t nThread, size_t slice);
+  // finish every submitted job, then join the workers
+  ~Scheduler();
+
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  void submit(std::unique_ptr<Execution> execution, Callback done,
+              size_t maxSteps = std::numeric_limits<size_t>::max());
+
+private:
+  struct Job {
+    std::unique_ptr<Execution> execution;
+    turing::util::Generator<const Tapes &> steps;
+    Callback done;
+  };
+
+  const size_t slice_;
+  std::deque<std::unique_ptr<Job>> queue_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  size_t pending_; // submitted jobs not completed yet
+  bool stopping_;
+  std::vector<std::thread> workers_;
+
+  void work();
+};
+
+} // namespace turing::machine
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/tape.h"
+
+namespace turing::machine {
+
+// .tm source usable as a template argument
+template <size_t N> struct FixedString {
+  char data[N]{};
+
+  constexpr FixedString(const char (&s)[N]) { std::copy_n(s, N, data); }
+  constexpr std::string_view view() const { return {data, N - 1}; }
+};
+
+namespace detail {
+
+constexpr std::string_view WHITESPACE = " \n\r\t\f\v";
+
+constexpr bool isTokenChar(char ch) {
+  return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') ||
+         (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+
+constexpr bool isPrint(char ch) { return ch >= 0x20 && ch < 0x7F; }
+
+// the sign rules of #S and #G in StatementParser
+constexpr bool isTapeSign(char ch) {
+  return isPrint(ch) && ch != ' ' && ch != ',' && ch != ';' && ch != '{' &&
+         ch != '}' && ch != '*';
+}
+
+constexpr bool isInputSign(char ch) { return isTapeSign(ch) && ch != '_'; }
+
+// The grammar of StatementParser over one trimmed statement. Errors throw,
+// which turns into a compile error in constant evaluation.
+class StaticStatementParser {
+public:
+  constexpr explicit StaticStatementParser(std::string_view statement)
+      : statement_(statement), index_(0) {}
+
+  constexpr char peekNextChar() const {
+    if (reachEnd()) {
+      throw std::invalid_argument("End of Statement");
+    }
+    return statement_[index_];
+  }
+
+  constexpr char mustNextChar() {
+    char ch = peekNextChar();
+    ++index_;
+    return ch;
+  }
+
+  constexpr void mustSkip(char expected) {
+    if (mustNextChar() != expected) {
+      throw std::invalid_argument("unexpected character");
+    }
+  }
+
+  constexpr bool skipIf(char expected) {
+    if (!reachEnd() && statement_[index_] == expected) {
+      ++index_;
+      return true;
+    }
+    return false;
+  }
+
+  constexpr std::string_view mustNextToken() {
+    size_t begin = index_;
+    while (!reachEnd() && isTokenChar(statement_[index_])) {
+      ++index_;
+    }
+    return statement_.substr(begin, index_ - begin);
+  }
+
+  // characters up to the next space
+  constexpr std::string_view mustNextWord() {
+    size_t begin = index_;
+    while (peekNextChar() != ' ') {
+      ++index_;
+    }
+    return statement_.substr(begin, index_ - begin);
+  }
+
+  // {a,b,c} of tokens
+  constexpr std::vector<std::string_view> mustNextTokens() {
+    std::vector<std::string_view> tokens;
+    mustSkip('{');
+    do {
+      std::string_view token = mustNextToken();
+      if (token.empty()) {
+        throw std::invalid_argument("should be a non-empty token");
+      }
+      if (std::find(tokens.begin(), tokens.end(), token) == tokens.end()) {
+        tokens.push_back(token);
+      }
+    } while (skipIf(','));
+    mustSkip('}');
+    return tokens;
+  }
+
+  // {a,b,c} of signs
+  constexpr std::string mustNextSigns(bool (*isValid)(char)) {
+    std::string signs;
+    mustSkip('{');
+    do {
+      char ch = mustNextChar();
+      if (!isValid(ch)) {
+        throw std::invalid_argument("sign not valid");
+      }
+      signs += ch;
+    } while (skipIf(','));
+    mustSkip('}');
+    return signs;
+  }
+
+private:
+  std::string_view statement_;
+  size_t index_;
+
+  constexpr bool reachEnd() const { return index_ == statement_.size(); }
+};
+
+struct StaticRule {
+  std::string_view oldState;
+  std::string_view oldSigns;
+  std::string_view newSigns;
+  std::string_view directions;
+  std::string_view newState;
+};
+
+// everything a .tm source says, parsed in constant evaluation
+struct StaticSource {
+  std::vector<std::string_view> states;
+  std::string inputSigns;
+  std::string tapeSigns;
+  std::string_view startState;
+  char blank = '_';
+  std::vector<std::string_view> finalStates;
+  size_t nTape = 0;
+  std::vector<StaticRule> rules;
+};
+
+constexpr StaticSource parseSource(std::string_view source) {
+  StaticSource parsed;
+
+  while (!source.empty()) {
+    size_t end = std::min(source.find('\n'), source.size());
+    std::string_view line = source.substr(0, end);
+    source.remove_prefix(std::min(end + 1, source.size()));
+
+    size_t first = line.find_first_not_of(WHITESPACE);
+    if (first == std::string_view::npos || line[first] == ';') {
+      continue;
+    }
+    line = line.substr(first, line.find_last_not_of(WHITESPACE) - first + 1);
+    StaticStatementParser parser{line};
+
+    if (parser.peekNextChar() != '#') {
+      StaticRule rule;
+      rule.oldState = parser.mustNextToken();
+      parser.mustSkip(' ');
+      rule.oldSigns = parser.mustNextWord();
+      parser.mustSkip(' ');
+      rule.newSigns = parser.mustNextWord();
+      parser.mustSkip(' ');
+      rule.directions = parser.mustNextWord();
+      parser.mustSkip(' ');
+      rule.newState = parser.mustNextToken();
+      parsed.rules.push_back(rule);
+      continue;
+    }
+
+    parser.mustSkip('#');
+    char sign = parser.mustNextChar();
+    if (sign == 'q') {
+      parser.mustNextChar(); // 0 of q0
+    }
+    parser.mustSkip(' ');
+    parser.mustSkip('=');
+    parser.mustSkip(' ');
+
+    switch (sign) {
+    case 'Q':
+      parsed.states = parser.mustNextTokens();
+      break;
+    case 'S':
+      parsed.inputSigns = parser.mustNextSigns(isInputSign);
+      break;
+    case 'G':
+      parsed.tapeSigns = parser.mustNextSigns(isTapeSign);
+      break;
+    case 'q':
+      parsed.startState = parser.mustNextToken();
+      break;
+    case 'B':
+      parsed.blank = parser.mustNextChar();
+      break;
+    case 'F':
+      parsed.finalStates = parser.mustNextTokens();
+      break;
+    case 'N': {
+      std::string_view number = parser.mustNextToken();
+      parsed.nTape = 0;
+      for (char ch : number) {
+        if (ch < '0' || ch > '9') {
+          throw std::invalid_argument("#N should be a number");
+        }
+        parsed.nTape = parsed.nTape * 10 + (ch - '0');
+      }
+      break;
+    }
+    default:
+      throw std::invalid_argument("sign not match");
+    }
+  }
+
+  auto checkState = [&parsed](std::string_view state) {
+    if (std::find(parsed.states.begin(), parsed.states.end(), state) ==
+        parsed.states.end()) {
+      throw std::invalid_argument("state not in #Q");
+    }
+  };
+  checkState(parsed.startState);
+  for (std::string_view state : parsed.finalStates) {
+    checkState(state);
+  }
+  for (const StaticRule &rule : parsed.rules) {
+    checkState(rule.oldState);
+    checkState(rule.newState);
+    if (rule.oldSigns.size() != parsed.nTape ||
+        rule.newSigns.size() != parsed.nTape ||
+        rule.directions.size() != parsed.nTape) {
+      throw std::invalid_argument("transition does not match #N");
+    }
+  }
+
+  return parsed;
+}
+
+constexpr size_t indexOf(const std::vector<std::string_view> &states,
+                         std::string_view state) {
+  auto it = std::find(states.begin(), states.end(), state);
+  if (it == states.end()) {
+    throw std::invalid_argument("state not in #Q");
+  }
+  return it - states.begin();
+}
+
+struct StaticShape {
+  size_t nState;
+  size_t nTape;
+  size_t nTransition;
+};
+
+constexpr StaticShape shapeOf(std::string_view source) {
+  StaticSource parsed = parseSource(source);
+  return {parsed.states.size(), parsed.nTape, parsed.rules.size()};
+}
+
+template <size_t NTape> struct StaticTransition {
+  std::array<char, NTape> oldSigns;
+  std::array<char, NTape> newSigns;
+  std::array<Direction, NTape> directions;
+  size_t newState;
+};
+
+// transitions of state s are transitions[first[s]] .. transitions[first[s+1]]
+template <size_t NState, size_t NTape, size_t NTransition> struct StaticTable {
+  size_t startState;
+  char blank;
+  std::array<bool, NState> isFinal;
+  std::array<bool, 256> isInput;
+  std::array<size_t, NState + 1> first;
+  std::array<StaticTransition<NTape>, NTransition> transitions;
+};
+
+template <size_t NState, size_t NTape, size_t NTransition>
+constexpr StaticTable<NState, NTape, NTransition> tableOf(std::string_view source) {
+  StaticSource parsed = parseSource(source);
+  StaticTable<NState, NTape, NTransition> table{};
+
+  table.startState = indexOf(parsed.states, parsed.startState);
+  table.blank = parsed.blank;
+  for (std::string_view state : parsed.finalStates) {
+    table.isFinal[indexOf(parsed.states, state)] = true;
+  }
+  for (char sign : parsed.inputSigns) {
+    table.isInput[static_cast<unsigned char>(sign)] = true;
+  }
+
+  // group by state, keeping the order of the source within a state
+  size_t next = 0;
+  for (size_t state = 0; state < NState; ++state) {
+    table.first[state] = next;
+    for (const StaticRule &rule : parsed.rules) {
+      if (indexOf(parsed.states, rule.oldState) != state) {
+        continue;
+      }
+      StaticTransition<NTape> &transition = table.transitions[next++];
+      for (size_t i = 0; i < NTape; ++i) {
+        transition.oldSigns[i] = rule.oldSigns[i];
+        transition.newSigns[i] = rule.newSigns[i];
+        transition.directions[i] = rule.directions[i] == 'l'   ? Direction::LEFT
+                                   : rule.directions[i] == 'r' ? Direction::RIGHT
+                                                               : Direction::STAY;
+      }
+      transition.newState = indexOf(parsed.states, rule.newState);
+    }
+  }
+  table.first[NState] = next;
+
+  return table;
+}
+
+} // namespace detail
+
+// A machine whose .tm source is parsed at compile time into tables sized by
+// its number of states, tapes and transitions. Steps look up those constant
+// tables directly, so nothing is parsed or interned at run time. Malformed
+// sources fail to compile.
+//
+//   using Palindrome = StaticMachine<R"(#Q = {0,cp,...} ...)">;
+//   auto result = Palindrome::run("1001001");
+template <FixedString Source> class StaticMachine {
+  static constexpr detail::StaticShape SHAPE = detail::shapeOf(Source.view());
+
+public:
+  static constexpr size_t N_STATE = SHAPE.nState;
+  static constexpr size_t N_TAPE = SHAPE.nTape;
+  static constexpr size_t N_TRANSITION = SHAPE.nTransition;
+
+  struct Result {
+    bool halted;
+    bool accepted;
+    size_t steps;
+    std::string content; // of tape 0
+  };
+
+  static constexpr bool isInputValid(std::string_view input) {
+    return std::all_of(input.begin(), input.end(), [](char ch) {
+      return TABLE.isInput[static_cast<unsigned char>(ch)];
+    });
+  }
+
+  // run on input for at most maxSteps steps
+  static Result run(std::string_view input,
+                    size_t maxSteps = std::numeric_limits<size_t>::max()) {
+    std::vector<Tape> tapes;
+    tapes.reserve(N_TAPE);
+    tapes.emplace_back(input, TABLE.blank);
+    for (size_t i = 1; i < N_TAPE; ++i) {
+      tapes.emplace_back(TABLE.blank);
+    }
+
+    size_t state = TABLE.startState;
+    bool accepted = TABLE.isFinal[state];
+    size_t steps = 0;
+    const Transition *transition = nullptr;
+
+    while (steps < maxSteps) {
+      std::array<char, N_TAPE> signs;
+      for (size_t i = 0; i < N_TAPE; ++i) {
+        signs[i] = tapes[i].currentSign();
+      }
+      if ((transition = determineTransition(state, signs)) == nullptr) {
+        break;
+      }
+
+      for (size_t i = 0; i < N_TAPE; ++i) {
+        tapes[i].move(transition->directions[i], transition->newSigns[i]);
+      }
+      state = transition->newState;
+      accepted |= TABLE.isFinal[state];
+      ++steps;
+    }
+
+    return {
+        .halted = transition == nullptr,
+        .accepted = accepted,
+        .steps = steps,
+        .content = tapes[0].contentString().value_or(""),
+    };
+  }
+
+private:
+  using Transition = detail::StaticTransition<N_TAPE>;
+
+  static constexpr detail::StaticTable<N_STATE, N_TAPE, N_TRANSITION> TABLE =
+      detail::tableOf<N_STATE, N_TAPE, N_TRANSITION>(Source.view());
+
+  // exact matches win over '*' patterns, like Machine::determineTransition
+  static constexpr const Transition *
+  determineTransition(size_t state, const std::array<char, N_TAPE> &signs) {
+    const Transition *begin = TABLE.transitions.data() + TABLE.first[state];
+    const Transition *end = TABLE.transitions.data() + TABLE.first[state + 1];
+
+    for (const Transition *it = begin; it != end; ++it) {
+      if (it->oldSigns == signs) {
+        return it;
+      }
+    }
+    for (const Transition *it = begin; it != end; ++it) {
+      bool matched = true;
+      for (size_t i = 0; i < N_TAPE; ++i) {
+        matched &= it->oldSigns[i] == signs[i] || it->oldSigns[i] == '*';
+      }
+      if (matched) {
+        return it;
+      }
+    }
+    return nullptr;
+  }
+};
+
+} // namespace turing::machine
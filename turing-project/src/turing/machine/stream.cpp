@@ -0,0 +1,112 @@
+#include "turing/machine/stream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include <unistd.h>
+
+#include "turing/machine/alphabet.h"
+#include "turing/machine/exception.h"
+
+namespace turing::machine {
+
+StreamInput::StreamInput(int fd, const Alphabet &alphabet)
+    : fd_(fd), alphabet_(alphabet), offset_(0) {}
+
+size_t StreamInput::read(char *buffer, size_t size) {
+  size_t n = 0;
+
+  while (n == 0) {
+    size_t held = held_.size();
+    if (held >= size) {
+      // too small a buffer to both flush and check for more data
+      std::copy(held_.begin(), held_.begin() + size, buffer);
+      held_.erase(0, size);
+      n = size;
+      break;
+    }
+
+    size_t fresh = readSome(buffer + held, size - held);
+    if (fresh == 0) {
+      return 0; // drop the withheld trailing newline
+    }
+    std::copy(held_.begin(), held_.end(), buffer);
+    held_.clear();
+    n = held + fresh;
+
+    std::string_view chunk{buffer, n};
+    if (chunk.ends_with("\r\n")) {
+      held_ = "\r\n";
+    } else if (chunk.ends_with('\n')) {
+      held_ = "\n";
+    }
+    n -= held_.size();
+  }
+
+  size_t index =
+      alphabet_.findFirstNotOf(std::string_view{buffer, static_cast<size_t>(n)});
+  if (index != std::string_view::npos) {
+    throw InvalidSymbolException(offset_ + index, buffer[index]);
+  }
+
+  offset_ += n;
+  return n;
+}
+
+size_t StreamInput::readSome(char *buffer, size_t size) {
+  ssize_t n;
+  do {
+    n = ::read(fd_, buffer, size);
+  } while (n < 0 && errno == EINTR);
+
+  if (n < 0) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+  return n;
+}
+
+SpillFile::SpillFile() : file_(std::tmpfile()) {
+  if (file_ == nullptr) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+}
+
+SpillFile::~SpillFile() { std::fclose(file_); }
+
+void SpillFile::write(uint64_t position, const char *cells, size_t size) {
+  off_t offset = static_cast<off_t>(position);
+  while (size > 0) {
+    ssize_t n = ::pwrite(fileno(file_), cells, size, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      throw std::runtime_error(std::strerror(errno));
+    }
+    cells += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+void SpillFile::read(uint64_t position, char *cells, size_t size) const {
+  off_t offset = static_cast<off_t>(position);
+  while (size > 0) {
+    ssize_t n = ::pread(fileno(file_), cells, size, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw std::runtime_error("spilled cells lost");
+    }
+    cells += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+} // namespace turing::machine
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "turing/machine/alphabet.h"
+
+namespace turing::machine {
+
+// Input of tape 0 read from a file descriptor (a file or a pipe) in chunks,
+// as the head first reaches them. Every chunk is checked against the input
+// alphabet when it is read. One trailing newline ends the input and is not
+// part of it.
+class StreamInput {
+public:
+  StreamInput(int fd, const Alphabet &alphabet);
+
+  // read up to size symbols, return 0 at the end of the input. Bytes of
+  // buffer past the returned count may be overwritten. Throw
+  // InvalidSymbolException on a symbol outside the alphabet.
+  size_t read(char *buffer, size_t size);
+
+private:
+  const int fd_;
+  const Alphabet &alphabet_;
+  size_t offset_;
+  std::string held_; // trailing line break withheld until more data comes
+
+  size_t readSome(char *buffer, size_t size);
+};
+
+// Anonymous temporary file holding tape cells moved out of memory. Cells are
+// stored at their position, counted by the tape from its first spilled
+// cell, so any range of cells can be written back and read again.
+class SpillFile {
+public:
+  SpillFile();
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  void write(uint64_t position, const char *cells, size_t size);
+  void read(uint64_t position, char *cells, size_t size) const;
+
+private:
+  std::FILE *file_;
+};
+
+} // namespace turing::machine
@@ -0,0 +1,58 @@
+#include "turing/machine/symbols.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+#include "turing/util/string.h"
+
+namespace turing::machine {
+
+SymbolTable::SymbolTable(const Machine &machine) {
+  std::array<bool, 256> used{};
+  auto use = [&used](char symbol) {
+    if (symbol != turing::util::string::STAR) {
+      used[static_cast<unsigned char>(symbol)] = true;
+    }
+  };
+
+  for (char symbol : machine.inputAlphabet()) {
+    use(symbol);
+  }
+  for (size_t id = 0; id < machine.nTransition(); ++id) {
+    const Transition &transition = machine.transition(id);
+    std::for_each(transition.oldSigns.begin(), transition.oldSigns.end(), use);
+    std::for_each(transition.newSigns.begin(), transition.newSigns.end(), use);
+  }
+
+  char blank = machine.blankSymbol();
+  used[static_cast<unsigned char>(blank)] = false;
+  symbols_.push_back(blank);
+  for (size_t i = 0; i < used.size(); ++i) {
+    if (used[i]) {
+      symbols_.push_back(static_cast<char>(i));
+    }
+  }
+
+  codes_.fill(wildcard());
+  for (size_t code = 0; code < symbols_.size(); ++code) {
+    codes_[static_cast<unsigned char>(symbols_[code])] =
+        static_cast<Code>(code);
+  }
+}
+
+size_t SymbolTable::size() const { return symbols_.size(); }
+
+Code SymbolTable::wildcard() const { return static_cast<Code>(symbols_.size()); }
+
+Code SymbolTable::code(char symbol) const {
+  return codes_[static_cast<unsigned char>(symbol)];
+}
+
+char SymbolTable::symbol(Code code) const {
+  return code < symbols_.size() ? symbols_[code] : turing::util::string::STAR;
+}
+
+} // namespace turing::machine
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace turing::machine {
+
+class Machine;
+
+// Code of a symbol on a compiled tape. A .tm symbol is one character other
+// than '*', so there are at most 255 of them and the wildcard fits as well.
+using Code = uint8_t;
+
+// Dense codes for the symbols a machine can ever have on its tapes: the
+// blank, the input symbols and every symbol a transition reads or writes.
+// The blank is code 0, the others follow in increasing order, and wildcard()
+// stands for '*' in transitions.
+class SymbolTable {
+public:
+  explicit SymbolTable(const Machine &machine);
+
+  // symbols, not counting the wildcard
+  size_t size() const;
+  // code of '*'
+  Code wildcard() const;
+  // code of a symbol of the table, or of '*'
+  Code code(char symbol) const;
+  char symbol(Code code) const;
+
+private:
+  std::array<Code, 256> codes_;
+  std::vector<char> symbols_;
+};
+
+} // namespace turing::machine
@@ -1,36 +1,255 @@
 #include "turing/machine/tape.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cmath>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
+#include <sys/uio.h>
+
+#include "turing/machine/stream.h"
 #include "turing/util/number.hpp"
 #include "turing/util/string.h"
 
 namespace turing::machine {
 
+namespace {
+// cells pulled from a StreamInput at a time
+constexpr size_t INPUT_CHUNK = 1 << 16;
+
+// loaded_ of a tape without a pending stream, never reached by the head
+constexpr int64_t NO_STREAM = std::numeric_limits<int64_t>::max();
+
+// Zobrist keys, derived from their position instead of looked up in a table
+// since tapes are unbounded. Blank cells have no key, so the untouched rest
+// of a tape hashes to nothing.
+uint64_t cellKey(size_t tape, int64_t index, char sign) {
+  return turing::util::number::mix(
+      turing::util::number::mix(static_cast<uint64_t>(index)) ^
+      ((static_cast<uint64_t>(tape) << 9) | static_cast<unsigned char>(sign)));
+}
+
+// Writes the content of a tape to fd with writev, trimming blanks at both
+// ends as it goes: blanks are held back until a non-blank symbol follows them,
+// and the prefix is written with the first non-blank symbol. Queued data is
+// referenced, not copied, so it must stay valid until flush().
+class ContentWriter {
+public:
+  ContentWriter(int fd, std::string_view prefix, char blank)
+      : fd_(fd), prefix_(prefix), blank_(blank), started_(false),
+        pendingBlanks_(0) {}
+
+  void append(const char *data, size_t size) {
+    if (!started_) {
+      const char *first = std::find_if(
+          data, data + size, [this](char ch) { return ch != blank_; });
+      if (first == data + size) {
+        return;
+      }
+      size -= first - data;
+      data = first;
+      started_ = true;
+      queue(prefix_.data(), prefix_.size());
+    }
+
+    size_t last = size;
+    while (last > 0 && data[last - 1] == blank_) {
+      --last;
+    }
+    if (last == 0) {
+      pendingBlanks_ += size;
+      return;
+    }
+
+    while (pendingBlanks_ > 0) {
+      if (blanks_.empty()) {
+        blanks_.assign(BLANK_CHUNK, blank_);
+      }
+      size_t n = std::min(pendingBlanks_, blanks_.size());
+      queue(blanks_.data(), n);
+      pendingBlanks_ -= n;
+    }
+    queue(data, last);
+    pendingBlanks_ = size - last;
+  }
+
+  void appendBlanks(size_t count) {
+    if (started_) {
+      pendingBlanks_ += count;
+    }
+  }
+
+  // write suffix if anything was written, return whether it was
+  bool finish(std::string_view suffix) {
+    if (started_) {
+      queue(suffix.data(), suffix.size());
+    }
+    flush();
+    return started_;
+  }
+
+  void flush() {
+    for (size_t begin = 0; begin < iov_.size();) {
+      ssize_t n = ::writev(fd_, iov_.data() + begin,
+                           static_cast<int>(iov_.size() - begin));
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        break; // like an ostream, a failed output is not an error of the run
+      }
+      // skip what was written, a partially written vector is resumed
+      for (; begin < iov_.size() && static_cast<size_t>(n) >= iov_[begin].iov_len;
+           ++begin) {
+        n -= iov_[begin].iov_len;
+      }
+      if (begin < iov_.size()) {
+        iov_[begin].iov_base = static_cast<char *>(iov_[begin].iov_base) + n;
+        iov_[begin].iov_len -= n;
+      }
+    }
+    iov_.clear();
+  }
+
+private:
+  static constexpr size_t BLANK_CHUNK = 1 << 16;
+  static constexpr size_t MAX_IOV = 64;
+
+  const int fd_;
+  const std::string_view prefix_;
+  const char blank_;
+  bool started_;
+  size_t pendingBlanks_;
+  std::string blanks_;
+  std::vector<iovec> iov_;
+
+  void queue(const char *data, size_t size) {
+    if (size == 0) {
+      return;
+    }
+    if (iov_.size() == MAX_IOV) {
+      flush();
+    }
+    iov_.push_back(iovec{
+        .iov_base = const_cast<char *>(data),
+        .iov_len = size,
+    });
+  }
+};
+
+uint64_t headKey(size_t tape, int64_t index) {
+  return turing::util::number::mix(
+      turing::util::number::mix(static_cast<uint64_t>(index)) ^
+      ((static_cast<uint64_t>(tape) << 9) | (uint64_t{1} << 8)));
+}
+
+uint64_t stateKey(const std::string &state) {
+  return turing::util::number::mix(std::hash<std::string>{}(state));
+}
+
+// hash delta of cell index going from sign from to sign to
+uint64_t cellDelta(size_t tape, int64_t index, char from, char to, char blank) {
+  uint64_t delta = 0;
+  if (from != to) {
+    if (from != blank) {
+      delta ^= cellKey(tape, index, from);
+    }
+    if (to != blank) {
+      delta ^= cellKey(tape, index, to);
+    }
+  }
+  return delta;
+}
+
+uint64_t headDelta(size_t tape, int64_t from, int64_t to) {
+  return from == to ? 0 : headKey(tape, from) ^ headKey(tape, to);
+}
+
+// a step never fires before a final state is entered
+constexpr size_t NEVER = std::numeric_limits<size_t>::max();
+} // namespace
+
 Tape::Tape(const char blank)
-    : tape_(std::unordered_map<int, char>()), head_(0), blank_(blank) {
-  tape_[head_] = blank;
+    : cells_(1, blank), origin_(0), head_(0), left_(0), right_(-1),
+      input_(nullptr), loaded_(NO_STREAM), spillBegin_(0), spillWindow_(0),
+      blank_(blank) {}
+
+Tape::Tape(std::string_view input, char blank)
+    : cells_(input.begin(), input.end()), origin_(0), head_(0), left_(0),
+      right_(static_cast<int64_t>(input.size()) - 1), input_(nullptr),
+      loaded_(NO_STREAM), spillBegin_(0), spillWindow_(0), blank_(blank) {
+  if (cells_.empty()) {
+    cells_.push_back(blank);
+  }
+}
+
+Tape::Tape(StreamInput &input, char blank, size_t spillWindow)
+    : cells_(1, blank), origin_(0), head_(0), left_(0), right_(-1),
+      input_(&input), loaded_(0), spillBegin_(0), spillWindow_(spillWindow),
+      blank_(blank) {
+  load();
+}
+
+void Tape::reset(std::string_view input) {
+  cells_.assign(input.begin(), input.end());
+  if (cells_.empty()) {
+    cells_.push_back(blank_);
+  }
+  origin_ = 0;
+  head_ = 0;
+  left_ = 0;
+  right_ = static_cast<int64_t>(input.size()) - 1;
+  input_ = nullptr;
+  loaded_ = NO_STREAM;
+  spill_.reset();
+  spillBegin_ = 0;
+  spillWindow_ = 0;
 }
 
-Tape::Tape(const std::string &input, char blank)
-    : tape_(std::unordered_map<int, char>()), head_(0), blank_(blank) {
-  for (size_t i = 0; i < input.size(); ++i) {
-    tape_[i] = input[i];
+char Tape::currentSign() const { return cellAt(head_); }
+
+int64_t Tape::head() const { return head_; }
+
+uint64_t Tape::hash(size_t tape) const {
+  uint64_t hash = headKey(tape, head_);
+
+  std::optional<std::string_view> view = contentView();
+  if (view.has_value()) {
+    for (size_t i = 0; i < view->size(); ++i) {
+      if ((*view)[i] != blank_) {
+        hash ^= cellKey(tape, left_ + static_cast<int64_t>(i), (*view)[i]);
+      }
+    }
   }
+
+  return hash;
 }
 
-char Tape::currentSign() const { return tape_.at(head_); }
+bool Tape::isSameConfiguration(const Tape &other) const {
+  std::optional<std::string_view> view = contentView();
+  std::optional<std::string_view> otherView = other.contentView();
+  // contentView() trimmed left_ to the first non-blank cell
+  return head_ == other.head_ && view == otherView &&
+         (!view.has_value() || left_ == other.left_);
+}
 
 void Tape::move(const Direction &direction, const char newSign) {
   if (newSign != turing::util::string::STAR) {
-    tape_[head_] = newSign;
+    cellAt(head_) = newSign;
+
+    if (newSign != blank_) {
+      widen(head_);
+    }
   }
 
   switch (direction) {
@@ -46,42 +265,44 @@ void Tape::move(const Direction &direction, const char newSign) {
     throw std::exception();
   }
 
-  if (!tape_.contains(head_)) {
-    tape_[head_] = blank_;
+  if (head_ + origin_ < 0 ||
+      head_ + origin_ >= static_cast<int64_t>(cells_.size()) ||
+      head_ == loaded_) {
+    relocate();
   }
 }
 
-std::optional<std::vector<TapeRecord>> Tape::content(bool reserveHead) {
-  std::vector<int> keys;
-
-  for (const auto &pair : tape_) {
-    keys.push_back(pair.first);
+void Tape::undo(const Direction &direction, const char oldSign) {
+  switch (direction) {
+  case Direction::LEFT:
+    ++head_;
+    break;
+  case Direction::RIGHT:
+    --head_;
+    break;
+  case Direction::STAY:
+    break;
+  default:
+    throw std::exception();
   }
-  std::sort(keys.begin(), keys.end());
-
-  int firstIndexOfKeys = std::numeric_limits<int>::max(),
-      lastIndexOfKeys = std::numeric_limits<int>::min();
 
-  for (size_t i = 0; i < keys.size(); ++i) {
-    int key = keys[i];
-    if ((reserveHead && key == head_) || tape_[key] != blank_) {
-      firstIndexOfKeys = i;
-      break;
-    }
+  if (head_ + origin_ < 0 ||
+      head_ + origin_ >= static_cast<int64_t>(cells_.size())) {
+    relocate();
   }
 
-  for (size_t i = keys.size(); i > 0; --i) {
-    int key = keys[i - 1];
-    if ((reserveHead && key == head_) || tape_[key] != blank_) {
-      lastIndexOfKeys = i - 1;
-      break;
-    }
+  cellAt(head_) = oldSign;
+  if (oldSign != blank_) {
+    widen(head_);
   }
+}
+
+std::optional<std::vector<TapeRecord>> Tape::content(bool reserveHead) const {
+  trim();
 
-  if (firstIndexOfKeys == std::numeric_limits<int>::max() ||
-      lastIndexOfKeys == std::numeric_limits<int>::min()) {
+  if (left_ > right_) {
     if (reserveHead) {
-      assert(tape_[head_] == blank_);
+      assert(cellAt(head_) == blank_);
       return std::vector<TapeRecord>{{
           .index = head_,
           .sign = blank_,
@@ -92,13 +313,16 @@ std::optional<std::vector<TapeRecord>> Tape::content(bool reserveHead) {
     }
   }
 
+  int64_t first = reserveHead ? std::min(left_, head_) : left_;
+  int64_t last = reserveHead ? std::max(right_, head_) : right_;
+
   std::vector<TapeRecord> records;
+  records.reserve(last - first + 1);
 
-  for (int i = firstIndexOfKeys; i <= lastIndexOfKeys; ++i) {
-    int index = keys[i];
+  for (int64_t index = first; index <= last; ++index) {
     records.push_back(TapeRecord{
         .index = index,
-        .sign = tape_[index],
+        .sign = cellOf(index),
         .isHead = index == head_,
     });
   }
@@ -106,35 +330,353 @@ std::optional<std::vector<TapeRecord>> Tape::content(bool reserveHead) {
   return records;
 }
 
-Tapes::Tapes(const std::string &input, const std::string &startState,
+std::optional<std::string_view> Tape::contentView() const {
+  assert(input_ == nullptr && spill_ == nullptr);
+
+  trim();
+
+  if (left_ > right_) {
+    return std::nullopt;
+  }
+
+  return std::string_view{&cellAt(left_),
+                          static_cast<size_t>(right_ - left_ + 1)};
+}
+
+std::optional<std::string> Tape::contentString() const {
+  if (input_ == nullptr && spill_ == nullptr) {
+    std::optional<std::string_view> view = contentView();
+    if (!view.has_value()) {
+      return std::nullopt;
+    }
+    return std::string{view.value()};
+  }
+
+  trim();
+
+  std::string s;
+
+  if (left_ <= right_) {
+    s.resize(right_ - left_ + 1);
+    int64_t split = std::clamp(memoryBegin(), left_, right_ + 1);
+    if (split > left_) {
+      spill_->read(left_ - spillBegin_, s.data(), split - left_);
+    }
+    if (split <= right_) {
+      std::copy(&cellAt(split), &cellAt(right_) + 1,
+                s.begin() + (split - left_));
+    }
+  }
+
+  if (input_ != nullptr) {
+    // the rest of the input has never been reached by the head
+    if (!s.empty()) {
+      s.append(loaded_ - right_ - 1, blank_);
+    }
+    char chunk[INPUT_CHUNK];
+    for (size_t n = input_->read(chunk, INPUT_CHUNK); n > 0;
+         n = input_->read(chunk, INPUT_CHUNK)) {
+      s.append(chunk, n);
+    }
+
+    size_t first = s.find_first_not_of(blank_);
+    if (first == std::string::npos) {
+      return std::nullopt;
+    }
+    s = s.substr(first, s.find_last_not_of(blank_) - first + 1);
+  }
+
+  if (s.empty()) {
+    return std::nullopt;
+  }
+
+  return s;
+}
+
+bool Tape::writeContent(int fd, std::string_view prefix,
+                        std::string_view suffix) const {
+  trim();
+
+  ContentWriter writer{fd, prefix, blank_};
+  std::vector<char> chunk;
+
+  if (left_ <= right_) {
+    int64_t split = std::clamp(memoryBegin(), left_, right_ + 1);
+    if (split > left_) {
+      chunk.resize(INPUT_CHUNK);
+      for (int64_t index = left_; index < split;) {
+        size_t n = std::min<size_t>(INPUT_CHUNK, split - index);
+        spill_->read(index - spillBegin_, chunk.data(), n);
+        writer.append(chunk.data(), n);
+        writer.flush();
+        index += n;
+      }
+    }
+    if (split <= right_) {
+      writer.append(&cellAt(split), right_ - split + 1);
+    }
+  }
+
+  if (input_ != nullptr) {
+    // the rest of the input has never been reached by the head
+    if (left_ <= right_) {
+      writer.appendBlanks(loaded_ - right_ - 1);
+    }
+    writer.flush();
+    chunk.resize(INPUT_CHUNK);
+    for (size_t n = input_->read(chunk.data(), INPUT_CHUNK); n > 0;
+         n = input_->read(chunk.data(), INPUT_CHUNK)) {
+      writer.append(chunk.data(), n);
+      writer.flush();
+    }
+  }
+
+  return writer.finish(suffix);
+}
+
+char &Tape::cellAt(int64_t index) { return cells_[index + origin_]; }
+
+const char &Tape::cellAt(int64_t index) const { return cells_[index + origin_]; }
+
+char Tape::cellOf(int64_t index) const {
+  if (index >= memoryBegin()) {
+    return cellAt(index);
+  }
+
+  char cell;
+  spill_->read(index - spillBegin_, &cell, 1);
+  return cell;
+}
+
+int64_t Tape::memoryBegin() const { return -origin_; }
+
+void Tape::widen(int64_t index) {
+  if (left_ > right_) {
+    left_ = right_ = index;
+  } else {
+    left_ = std::min(left_, index);
+    right_ = std::max(right_, index);
+  }
+}
+
+void Tape::relocate() {
+  if (head_ == loaded_) {
+    load();
+  }
+
+  if (head_ < memoryBegin()) {
+    if (spill_ != nullptr && spillBegin_ < memoryBegin()) {
+      unspill();
+    } else {
+      grow();
+      spillBegin_ = memoryBegin();
+    }
+  } else if (head_ + origin_ >= static_cast<int64_t>(cells_.size())) {
+    spill();
+    if (head_ + origin_ >= static_cast<int64_t>(cells_.size())) {
+      grow();
+    }
+  }
+}
+
+void Tape::grow() {
+  size_t size = cells_.size();
+
+  if (head_ + origin_ < 0) {
+    // double towards the left and shift the used cells to the upper half
+    std::vector<char> cells(size * 2, blank_);
+    std::copy(cells_.begin(), cells_.end(), cells.begin() + size);
+    cells_ = std::move(cells);
+    origin_ += static_cast<int64_t>(size);
+  } else {
+    cells_.resize(size * 2, blank_);
+  }
+}
+
+void Tape::load() {
+  spill();
+  while (loaded_ + static_cast<int64_t>(INPUT_CHUNK) + origin_ >
+         static_cast<int64_t>(cells_.size())) {
+    cells_.resize(cells_.size() * 2, blank_);
+  }
+
+  size_t n = input_->read(&cellAt(loaded_), INPUT_CHUNK);
+  // the read may clobber cells past the ones it returns
+  std::fill(&cellAt(loaded_) + n, &cellAt(loaded_) + INPUT_CHUNK, blank_);
+  if (n == 0) {
+    input_ = nullptr;
+    loaded_ = NO_STREAM;
+    return;
+  }
+
+  if (left_ > right_) {
+    left_ = loaded_;
+  }
+  right_ = loaded_ + static_cast<int64_t>(n) - 1;
+  loaded_ += static_cast<int64_t>(n);
+}
+
+void Tape::spill() {
+  if (spillWindow_ == 0 ||
+      head_ - memoryBegin() <= 2 * static_cast<int64_t>(spillWindow_)) {
+    return;
+  }
+
+  // keep spillWindow_ cells behind the head in memory
+  int64_t count = head_ - static_cast<int64_t>(spillWindow_) - memoryBegin();
+  if (spill_ == nullptr) {
+    spill_ = std::make_unique<SpillFile>();
+    spillBegin_ = memoryBegin();
+  }
+  spill_->write(memoryBegin() - spillBegin_, cells_.data(), count);
+  cells_.erase(cells_.begin(), cells_.begin() + count);
+  origin_ -= count;
+}
+
+void Tape::unspill() {
+  int64_t count =
+      std::min(memoryBegin() - spillBegin_,
+               static_cast<int64_t>(std::max(spillWindow_, INPUT_CHUNK)));
+  std::vector<char> cells(count);
+  spill_->read(memoryBegin() - count - spillBegin_, cells.data(), count);
+  cells_.insert(cells_.begin(), cells.begin(), cells.end());
+  origin_ += count;
+}
+
+void Tape::trim() const {
+  while (left_ <= right_ && cellOf(left_) == blank_) {
+    ++left_;
+  }
+  while (left_ <= right_ && cellOf(right_) == blank_) {
+    --right_;
+  }
+}
+
+Tapes::Tapes(std::string_view input, const std::string &startState,
+             const std::unordered_set<std::string> &finalStates,
+             const size_t nTape, const char blank)
+    : Tapes(Tape{input, blank}, startState, finalStates, nTape, blank) {}
+
+Tapes::Tapes(StreamInput &input, const std::string &startState,
+             const std::unordered_set<std::string> &finalStates,
+             const size_t nTape, const char blank)
+    : Tapes(Tape{input, blank}, startState, finalStates, nTape, blank) {}
+
+Tapes::Tapes(Tape first, const std::string &startState,
              const std::unordered_set<std::string> &finalStates,
              const size_t nTape, const char blank)
     : step_(0), currentState_(startState), finalStates_(finalStates),
       accepted_(finalStates.contains(startState)),
+      acceptedAt_(accepted_ ? 0 : NEVER), hashing_(false), hash_(0),
       padLeft_([nTape](const std::string &s) -> std::string {
         return turing::util::string::padRight(
                    s, 5 + turing::util::number::length(nTape - 1) + 1) +
                std::string{turing::util::string::COLON} +
                std::string{turing::util::string::SPACE};
-      }) {
-  tapes_.emplace_back(input, blank);
+      }),
+      blank_(blank) {
+  tapes_.push_back(std::move(first));
   for (size_t i = 1; i < nTape; ++i) {
     tapes_.emplace_back(blank);
   }
 }
 
+void Tapes::reset(std::string_view input, const std::string &startState) {
+  step_ = 0;
+  currentState_ = startState;
+  accepted_ = finalStates_.contains(startState);
+  acceptedAt_ = accepted_ ? 0 : NEVER;
+  hashing_ = false;
+  hash_ = 0;
+
+  tapes_[0].reset(input);
+  for (size_t i = 1; i < tapes_.size(); ++i) {
+    tapes_[i].reset({});
+  }
+}
+
 void Tapes::step(const Transition &transition) {
+  if (hashing_) {
+    hash_ ^= stateKey(currentState_) ^ stateKey(transition.newState);
+  }
+
   currentState_ = transition.newState;
-  accepted_ |= finalStates_.contains(currentState_);
   ++step_;
+  if (!accepted_ && finalStates_.contains(currentState_)) {
+    accepted_ = true;
+    acceptedAt_ = step_;
+  }
 
   assert(transition.newSigns.size() == tapes_.size());
   for (size_t i = 0; i < tapes_.size(); ++i) {
-    tapes_[i].move(transition.directions[i], transition.newSigns[i]);
+    Tape &tape = tapes_[i];
+
+    if (!hashing_) {
+      tape.move(transition.directions[i], transition.newSigns[i]);
+      continue;
+    }
+
+    int64_t head = tape.head();
+    char oldSign = tape.currentSign();
+    char newSign = transition.newSigns[i] == turing::util::string::STAR
+                       ? oldSign
+                       : transition.newSigns[i];
+    tape.move(transition.directions[i], transition.newSigns[i]);
+
+    hash_ ^= cellDelta(i, head, oldSign, newSign, blank_) ^
+             headDelta(i, head, tape.head());
+  }
+}
+
+void Tapes::undo(const Transition &transition, const char *oldSigns) {
+  if (hashing_) {
+    hash_ ^= stateKey(currentState_) ^ stateKey(transition.oldState);
+  }
+
+  currentState_ = transition.oldState;
+  --step_;
+  accepted_ = step_ >= acceptedAt_;
+
+  assert(transition.newSigns.size() == tapes_.size());
+  for (size_t i = 0; i < tapes_.size(); ++i) {
+    Tape &tape = tapes_[i];
+    int64_t head = tape.head();
+    tape.undo(transition.directions[i], oldSigns[i]);
+
+    if (hashing_) {
+      char newSign = transition.newSigns[i] == turing::util::string::STAR
+                         ? oldSigns[i]
+                         : transition.newSigns[i];
+      hash_ ^= cellDelta(i, tape.head(), newSign, oldSigns[i], blank_) ^
+               headDelta(i, head, tape.head());
+    }
+  }
+}
+
+void Tapes::trackHash() {
+  hash_ = stateKey(currentState_);
+  for (size_t i = 0; i < tapes_.size(); ++i) {
+    hash_ ^= tapes_[i].hash(i);
   }
+  hashing_ = true;
 }
 
-std::string Tapes::id() {
+uint64_t Tapes::hash() const { return hash_; }
+
+bool Tapes::isSameConfiguration(const Tapes &other) const {
+  if (currentState_ != other.currentState_ ||
+      tapes_.size() != other.tapes_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < tapes_.size(); ++i) {
+    if (!tapes_[i].isSameConfiguration(other.tapes_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string Tapes::id() const {
   std::string s;
 
   s += padLeft_("Step") + std::to_string(step_) + "\n";
@@ -142,7 +684,7 @@ std::string Tapes::id() {
   s += padLeft_("Acc") + (accepted_ ? "Yes" : "No") + "\n";
 
   for (size_t i = 0; i < tapes_.size(); ++i) {
-    Tape &tape = tapes_[i];
+    const Tape &tape = tapes_[i];
 
     auto op = tape.content(true);
     assert(op.has_value());
@@ -192,26 +734,33 @@ TapeView Tapes::currentView() const {
   };
 }
 
-std::optional<std::string> Tapes::content() {
-  assert(!tapes_.empty());
+int64_t Tapes::head(size_t tape) const { return tapes_[tape].head(); }
 
-  std::optional<std::vector<TapeRecord>> optionalRecords = tapes_[0].content();
+char Tapes::currentSign(size_t tape) const {
+  return tapes_[tape].currentSign();
+}
 
-  if (!optionalRecords.has_value()) {
-    return std::nullopt;
+void Tapes::currentSigns(char *signs) const {
+  for (size_t i = 0; i < tapes_.size(); ++i) {
+    signs[i] = tapes_[i].currentSign();
   }
+}
 
-  std::vector<TapeRecord> records = optionalRecords.value();
+std::optional<std::string> Tapes::content() const {
+  assert(!tapes_.empty());
 
-  std::string s;
+  return tapes_[0].contentString();
+}
 
-  for (const TapeRecord &record : records) {
-    s += record.sign;
-  }
+bool Tapes::writeContent(int fd, std::string_view prefix,
+                         std::string_view suffix) const {
+  assert(!tapes_.empty());
 
-  return s;
+  return tapes_[0].writeContent(fd, prefix, suffix);
 }
 
-bool Tapes::isAccepted() { return accepted_; }
+bool Tapes::isAccepted() const { return accepted_; }
+
+size_t Tapes::steps() const { return step_; }
 
 } // namespace turing::machine
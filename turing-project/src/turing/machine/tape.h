@@ -1,14 +1,17 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <unordered_set>
 
 #include "turing/machine/direction.h"
+#include "turing/machine/stream.h"
 #include "turing/machine/transition.h"
 
 namespace turing::machine {
@@ -19,46 +22,133 @@ struct TapeView {
 };
 
 struct TapeRecord {
-  int index;
+  int64_t index;
   char sign;
   bool isHead;
 };
 
 class Tape {
 public:
+  // cells kept in memory behind the head of a streamed tape
+  static constexpr size_t SPILL_WINDOW = 1 << 24;
+
   Tape(const char blank);
-  Tape(const std::string &input, const char blank);
+  Tape(std::string_view input, const char blank);
+  // tape fed lazily from input as the head reaches new cells. Cells more
+  // than spillWindow behind the head are moved out to a temporary file.
+  Tape(StreamInput &input, const char blank,
+       size_t spillWindow = SPILL_WINDOW);
+
+  // start over with input on the tape, keeping the allocated cells
+  void reset(std::string_view input);
 
   char currentSign() const;
+  int64_t head() const;
+  // Zobrist hash of the head position and the non-blank cells of the tape
+  // numbered tape. Only defined for tapes entirely in memory.
+  uint64_t hash(size_t tape) const;
+  // same head position and non-blank cells. Only defined for tapes entirely
+  // in memory.
+  bool isSameConfiguration(const Tape &other) const;
   void move(const Direction &direction, const char newSign);
-  std::optional<std::vector<TapeRecord>> content(bool reserveHead = false);
+  // revert a move in direction that overwrote oldSign
+  void undo(const Direction &direction, const char oldSign);
+  std::optional<std::vector<TapeRecord>> content(bool reserveHead = false) const;
+  // non-blank range of a tape that is entirely in memory
+  std::optional<std::string_view> contentView() const;
+  // non-blank range of any tape. The unread rest of a streamed input is
+  // consumed by this call, so it is meant to be called once the run halts.
+  std::optional<std::string> contentString() const;
+  // Write prefix, the content and suffix to fd, in large chunks and without
+  // building the content in memory. Nothing is written, and false returned,
+  // when the tape is blank. Consumes a streamed input like contentString().
+  bool writeContent(int fd, std::string_view prefix = {},
+                    std::string_view suffix = {}) const;
 
 private:
-  std::unordered_map<int, char> tape_;
-  int head_;
+  // Cell indexes are 64-bit: a streamed tape keeps only a window of cells
+  // in memory, so its head can go further than an int reaches.
+  std::vector<char> cells_; // cells_[index + origin_] holds cell `index`
+  int64_t origin_;
+  int64_t head_;
+
+  // every non-blank cell lies in [left_, right_] (empty when left_ > right_).
+  // Non-blank writes widen the range; blanks written at its ends are trimmed
+  // lazily on the next content extraction.
+  mutable int64_t left_;
+  mutable int64_t right_;
+
+  StreamInput *input_; // null once the whole input is on the tape
+  int64_t loaded_;     // cells [0, loaded_) have been read from input_
+
+  std::unique_ptr<SpillFile> spill_;
+  // cells [spillBegin_, memoryBegin()) live in spill_, cell spillBegin_ at
+  // its position 0
+  int64_t spillBegin_;
+  size_t spillWindow_;
 
   const char blank_;
+
+  char &cellAt(int64_t index);
+  const char &cellAt(int64_t index) const;
+  char cellOf(int64_t index) const;
+  int64_t memoryBegin() const;
+  void widen(int64_t index);
+  void relocate();
+  void grow();
+  void load();
+  void spill();
+  void unspill();
+  void trim() const;
 };
 
 class Tapes {
 public:
-  Tapes(const std::string &input, const std::string &startState, const std::unordered_set<std::string> &finalStates_, const size_t nTape, const char blank);
+  Tapes(std::string_view input, const std::string &startState, const std::unordered_set<std::string> &finalStates_, const size_t nTape, const char blank);
+  Tapes(StreamInput &input, const std::string &startState, const std::unordered_set<std::string> &finalStates_, const size_t nTape, const char blank);
+
+  // start over from startState with input on tape 0 and the other tapes
+  // blank, reusing the cells of every tape
+  void reset(std::string_view input, const std::string &startState);
 
   void step(const Transition &transition);
-  std::string id();
+  // revert step(transition), given the symbols it overwrote
+  void undo(const Transition &transition, const char *oldSigns);
+  // Keep a Zobrist hash of the whole configuration (state, heads and cells)
+  // from now on, updated in O(nTape) per step. Tapes must be in memory.
+  void trackHash();
+  uint64_t hash() const;
+  // same state, heads and cells, what hash() stands for. Tapes must be in
+  // memory.
+  bool isSameConfiguration(const Tapes &other) const;
+  std::string id() const;
   std::string currentState() const;
   TapeView currentView() const;
-  std::optional<std::string> content();
-  bool isAccepted();
+  int64_t head(size_t tape) const;
+  char currentSign(size_t tape) const;
+  // write the symbol under every head into signs
+  void currentSigns(char *signs) const;
+  std::optional<std::string> content() const;
+  // Tape::writeContent of tape 0
+  bool writeContent(int fd, std::string_view prefix = {},
+                    std::string_view suffix = {}) const;
+  bool isAccepted() const;
+  size_t steps() const;
 
 private:
   std::vector<Tape> tapes_;
   size_t step_;
   std::string currentState_;
   bool accepted_;
+  size_t acceptedAt_; // step a final state was first entered
+  bool hashing_;
+  uint64_t hash_;
 
   const std::function<std::string(const std::string&)> padLeft_;
-  const std::unordered_set<std::string> finalStates_;
+  const std::unordered_set<std::string> &finalStates_;
+  const char blank_;
+
+  Tapes(Tape first, const std::string &startState, const std::unordered_set<std::string> &finalStates_, const size_t nTape, const char blank);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "turing/machine/trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "turing/machine/machine.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+#include "turing/util/string.h"
+
+namespace turing::machine {
+
+TraceFilter::TraceFilter(const Machine &machine, const TraceOption &option)
+    : every_(std::max<size_t>(option.every, 1)), tape_(option.tape) {
+  for (const std::string &state : option.states) {
+    if (!machine.states().contains(state)) {
+      throw std::invalid_argument("unknown state " + state);
+    }
+  }
+  if (tape_.has_value() && tape_.value() >= machine.nTape()) {
+    throw std::invalid_argument("no tape " + std::to_string(tape_.value()));
+  }
+
+  if (!option.states.empty()) {
+    entering_.resize(machine.nTransition(), 0);
+    for (size_t id = 0; id < machine.nTransition(); ++id) {
+      const Transition &transition = machine.transition(id);
+      entering_[id] = transition.oldState != transition.newState &&
+                      std::find(option.states.begin(), option.states.end(),
+                                transition.newState) != option.states.end();
+    }
+  }
+}
+
+bool TraceFilter::selectStart() const {
+  return entering_.empty() && !tape_.has_value();
+}
+
+bool TraceFilter::select(const Transition &transition,
+                         const Tapes &tapes) const {
+  if ((tapes.steps() + 1) % every_ != 0) {
+    return false;
+  }
+  if (!entering_.empty() && !entering_[transition.id]) {
+    return false;
+  }
+  if (tape_.has_value()) {
+    char sign = transition.newSigns[tape_.value()];
+    if (sign == turing::util::string::STAR ||
+        sign == tapes.currentSign(tape_.value())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace turing::machine
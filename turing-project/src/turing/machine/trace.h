@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+
+namespace turing::machine {
+
+class Machine;
+
+// Which steps a verbose run prints. A step is printed when it passes every
+// filter that is set; the defaults print every step.
+struct TraceOption {
+  size_t every = 1;                // steps that are a multiple of every
+  std::vector<std::string> states; // steps entering one of states
+  std::optional<size_t> tape;      // steps changing a cell of tape
+  size_t last = 0; // if not 0, print only the last selected steps at halt
+
+  bool operator==(const TraceOption &other) const = default;
+};
+
+// TraceOption compiled against the transition ids of a machine, deciding
+// about a step before it happens so that unselected steps are never
+// formatted.
+class TraceFilter {
+public:
+  // throw std::invalid_argument for unknown states or tapes
+  TraceFilter(const Machine &machine, const TraceOption &option);
+
+  // whether the configuration a run starts in is printed
+  bool selectStart() const;
+  // whether the step firing transition from tapes is printed
+  bool select(const Transition &transition, const Tapes &tapes) const;
+
+private:
+  size_t every_;
+  std::vector<uint8_t> entering_; // by transition id, empty for any
+  std::optional<size_t> tape_;
+};
+
+} // namespace turing::machine
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,7 @@ struct Transition {
   std::vector<char> newSigns;
   std::vector<turing::machine::Direction> directions;
   std::string newState;
+  size_t id = 0; // dense index assigned by Machine, not part of equality
 
   bool operator==(const Transition &other) const {
     return this->oldState == other.oldState &&
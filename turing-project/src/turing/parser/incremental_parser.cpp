@@ -0,0 +1,113 @@
+#include "turing/parser/incremental_parser.h"
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turing/machine/machine.h"
+#include "turing/parser/parser.hpp"
+#include "turing/parser/result.h"
+#include "turing/parser/statement_parser.h"
+#include "turing/util/file.h"
+
+namespace turing::parser {
+
+namespace {
+// lines parsed into an arena before dead ones are worth dropping
+constexpr size_t MIN_COMPACT = 64;
+} // namespace
+
+IncrementalParser::IncrementalParser(std::string filepath)
+    : filepath_(std::move(filepath)),
+      arena_(std::make_unique<std::pmr::monotonic_buffer_resource>()),
+      names_(std::make_unique<StringTable>(arena_.get())), reparsed_(0),
+      parsedInArena_(0) {}
+
+turing::machine::Machine IncrementalParser::parse() {
+  std::string source = turing::util::file::read(filepath_);
+
+  Results results;
+  std::vector<const StatementResult *> statements;
+  size_t reparsed = 0;
+
+  try {
+    for (std::string_view rest = source; !rest.empty();) {
+      size_t end = rest.find('\n');
+      std::string_view line = rest.substr(0, end);
+      rest = end == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(end + 1);
+
+      auto it = results.find(line);
+      if (it == results.end()) {
+        if (auto previous = results_.find(line); previous != results_.end()) {
+          it = results.insert(results_.extract(previous)).position;
+        } else {
+          // parse from the key, which results view. The placeholder is of
+          // another alternative, so the result is moved in with its arena.
+          it = results.try_emplace(std::string{line}, EmptyStatementResult{})
+                   .first;
+          ++parsedInArena_;
+          try {
+            it->second = parseStatement(it->first, *names_, arena_.get());
+          } catch (...) {
+            results.erase(it);
+            throw;
+          }
+          ++reparsed;
+        }
+      }
+      statements.push_back(&it->second);
+    }
+  } catch (...) {
+    results_.merge(results);
+    throw;
+  }
+
+  // the builder is only needed for this version
+  std::pmr::monotonic_buffer_resource scratch;
+  MachineBuilder builder{&scratch};
+  for (const StatementResult *statement : statements) {
+    builder.add(*statement);
+  }
+  turing::machine::Machine machine = builder.build();
+
+  // lines gone from the file are dropped
+  results_ = std::move(results);
+  reparsed_ = reparsed;
+  if (parsedInArena_ > MIN_COMPACT && parsedInArena_ > 2 * results_.size()) {
+    compact();
+  }
+  return machine;
+}
+
+size_t IncrementalParser::reparsed() const { return reparsed_; }
+
+size_t IncrementalParser::interned() const { return names_->size(); }
+
+void IncrementalParser::compact() {
+  auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+  auto names = std::make_unique<StringTable>(arena.get());
+
+  // all live lines parsed before, so only allocation can fail, and results_
+  // is left alone until nothing can
+  std::vector<StatementResult> fresh;
+  fresh.reserve(results_.size());
+  for (const auto &[line, result] : results_) {
+    fresh.push_back(parseStatement(line, *names, arena.get()));
+  }
+
+  auto next = fresh.begin();
+  for (auto &[line, result] : results_) {
+    // through another alternative, so that the result keeps its new arena
+    result = EmptyStatementResult{};
+    result = std::move(*next++);
+  }
+  // the old table frees into the old arena, so it goes first
+  names_ = std::move(names);
+  arena_ = std::move(arena);
+  parsedInArena_ = results_.size();
+}
+
+} // namespace turing::parser
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "turing/machine/machine.h"
+#include "turing/parser/result.h"
+#include "turing/parser/string_table.h"
+
+namespace turing::parser {
+
+// Parses successive versions of one .tm file. The result of every line of the
+// previous version is kept by its text, so a new version only parses the
+// lines that were added or edited; unchanged lines, wherever they moved, are
+// reused. Results of lines gone from the file are dropped, and once they
+// outnumber the live ones the arena and string table are rebuilt from the
+// live lines, so a long-running process does not grow with every edit. Not
+// thread-safe.
+class IncrementalParser {
+public:
+  explicit IncrementalParser(std::string filepath);
+
+  // parse the current content of the file. On a syntax error the results of
+  // the previous version are kept.
+  turing::machine::Machine parse();
+
+  // lines the last parse() had to parse
+  size_t reparsed() const;
+  // state names held in the string table, for live lines and dead ones not
+  // dropped yet
+  size_t interned() const;
+
+private:
+  struct LineHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view line) const {
+      return std::hash<std::string_view>{}(line);
+    }
+  };
+  using Results =
+      std::unordered_map<std::string, StatementResult, LineHash, std::equal_to<>>;
+
+  const std::string filepath_;
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+  std::unique_ptr<StringTable> names_;
+  // nodes are stable, so results may view the line they key
+  Results results_;
+  size_t reparsed_;
+  size_t parsedInArena_; // statements parsed into arena_, live or not
+
+  // parse the live lines again into a fresh arena and string table
+  void compact();
+};
+
+} // namespace turing::parser
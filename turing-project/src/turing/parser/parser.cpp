@@ -1,21 +1,132 @@
 #include "turing/parser/parser.hpp"
+
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "turing/machine/machine.h"
 #include "turing/parser/result.h"
+#include "turing/parser/statement_parser.h"
 
 namespace turing::parser {
 
+namespace {
+template <class... Ts> struct overload : Ts... {
+  using Ts::operator()...;
+};
+template <class... Ts> overload(Ts...) -> overload<Ts...>;
+
+std::unordered_set<std::string>
+toSet(const std::pmr::vector<std::string_view> &names) {
+  std::unordered_set<std::string> set;
+  set.reserve(names.size());
+  for (std::string_view name : names) {
+    set.emplace(name);
+  }
+  return set;
+}
+} // namespace
+
+MachineBuilder::MachineBuilder(std::pmr::memory_resource *arena)
+    : states_(arena), blankSymbol_(), finalStates_(arena), nTape_(),
+      transitions_(arena) {}
+
+void MachineBuilder::add(const StatementResult &result) {
+  std::visit(
+      overload{
+          [this](const NormalStatementResult &normalStatementResult) {
+            std::visit(
+                overload{
+                    [this](const StatesResult &statesResult) {
+                      states_ = statesResult.states;
+                    },
+                    [this](const InputAlphabetResult &inputAlphabetResult) {
+                      inputAlphabet_ = inputAlphabetResult.inputAlphabet;
+                    },
+                    [this](const TapeAlphabetResult &tapeAlphabetResult) {
+                      tapeAlphabet_ = tapeAlphabetResult.tapeAlphabet;
+                    },
+                    [this](const StartStateResult &startStateResult) {
+                      startState_ = startStateResult.startState;
+                    },
+                    [this](const FinalStatesResult &finalStatesResult) {
+                      finalStates_ = finalStatesResult.finalStates;
+                    },
+                    [this](const BlankSymbolResult &blankSymbolResult) {
+                      blankSymbol_ = blankSymbolResult.blankSymbol;
+                    },
+                    [this](const NTapeResult &nTapeResult) {
+                      nTape_ = nTapeResult.nTape;
+                    }},
+                normalStatementResult);
+          },
+          [this](const TransitionStatementResult &transitionStatementResult) {
+            transitions_[transitionStatementResult.oldState.data()].push_back(
+                &transitionStatementResult);
+          },
+          [](const EmptyStatementResult &) {},
+          [](const CommentStatementResult &) {},
+      },
+      result);
+}
+
+turing::machine::Machine MachineBuilder::build() const {
+  std::unordered_map<std::string, std::vector<turing::machine::Transition>>
+      transitions;
+  transitions.reserve(transitions_.size());
+  for (const auto &[_, results] : transitions_) {
+    auto &subTransitions = transitions[std::string{results.front()->oldState}];
+    subTransitions.reserve(results.size());
+    for (const TransitionStatementResult *result : results) {
+      subTransitions.push_back(toTransition(*result));
+    }
+  }
+
+  return machine::Machine{toSet(states_),  inputAlphabet_,
+                          tapeAlphabet_,   std::string{startState_},
+                          blankSymbol_,    toSet(finalStates_),
+                          nTape_,          std::move(transitions)};
+}
+
 Parser::Parser(const std::string &filepath)
-    : statements_(turing::util::file::readLines(filepath)), index_(0) {}
+    : source_(turing::util::file::read(filepath)), rest_(source_),
+      names_(&arena_) {}
+
+turing::machine::Machine Parser::parse() {
+  // results are kept until the machine is built
+  std::pmr::vector<StatementResult> results{&arena_};
+  MachineBuilder builder{&arena_};
+
+  std::optional<std::string_view> statement;
+  while ((statement = this->nextStatement()) != std::nullopt) {
+    results.push_back(parseStatement(*statement, names_, &arena_));
+  }
+  for (const StatementResult &result : results) {
+    builder.add(result);
+  }
 
-std::optional<std::string> Parser::nextStatement() {
-  if (index_ == statements_.size()) {
+  return builder.build();
+}
+
+std::optional<std::string_view> Parser::nextStatement() {
+  if (rest_.empty()) {
     return std::nullopt;
   }
 
-  return statements_[index_++];
+  size_t end = rest_.find('\n');
+  std::string_view statement = rest_.substr(0, end);
+  rest_ = end == std::string_view::npos ? std::string_view{}
+                                        : rest_.substr(end + 1);
+  return statement;
 }
 
 turing::machine::Machine parse(const std::string &filepath) {
   return Parser{filepath}.parse();
 }
 
-}
\ No newline at end of file
+}
@@ -1,94 +1,62 @@
 #pragma once
 
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "turing/machine/machine.h"
 #include "turing/parser/result.h"
 #include "turing/parser/statement_parser.h"
+#include "turing/parser/string_table.h"
 #include "turing/util/file.h"
 
 namespace turing::parser {
-namespace {
-template <class... Ts> struct overload : Ts... {
-  using Ts::operator()...;
+
+// Folds the statements of a .tm file, in file order, into a Machine. Results
+// are kept by view, so they must outlive the builder.
+class MachineBuilder {
+public:
+  explicit MachineBuilder(std::pmr::memory_resource *arena);
+
+  void add(const StatementResult &result);
+  turing::machine::Machine build() const;
+
+private:
+  std::pmr::vector<std::string_view> states_;
+  std::unordered_set<char> inputAlphabet_;
+  std::unordered_set<char> tapeAlphabet_;
+  std::string_view startState_;
+  char blankSymbol_;
+  std::pmr::vector<std::string_view> finalStates_;
+  size_t nTape_;
+  // grouped by old state, interned names compare by pointer
+  std::pmr::unordered_map<const char *,
+                          std::pmr::vector<const TransitionStatementResult *>>
+      transitions_;
 };
-template <class... Ts> overload(Ts...) -> overload<Ts...>;
-} // namespace
 
+// Parses a .tm file. Statements are parsed in place in the file buffer and
+// everything they produce is allocated from one arena, released with the
+// Parser; only the Machine is built with the global allocator.
 class Parser {
 public:
   explicit Parser(const std::string &filepath);
 
-  turing::machine::Machine parse() {
-    std::unordered_set<std::string> states;
-    std::unordered_set<char> inputAlphabet;
-    std::unordered_set<char> tapeAlphabet;
-    std::string startState;
-    char blankSymbol;
-    std::unordered_set<std::string> finalStates;
-    size_t nTape;
-    std::unordered_map<std::string, std::vector<turing::machine::Transition>> transitions;
-
-    std::optional<std::string> statement;
-    while ((statement = this->nextStatement()) != std::nullopt) {
-      std::visit(
-          overload{
-              [&states, &inputAlphabet, &tapeAlphabet, &startState,
-               &finalStates, &blankSymbol,
-               &nTape](const NormalStatementResult &normalStatementResult) {
-                std::visit(
-                    overload{
-                        [&states](const StatesResult &statesResult) {
-                          states = statesResult.states;
-                        },
-                        [&inputAlphabet](
-                            const InputAlphabetResult &inputAlphabetResult) {
-                          inputAlphabet = inputAlphabetResult.inputAlphabet;
-                        },
-                        [&tapeAlphabet](
-                            const TapeAlphabetResult &tapeAlphabetResult) {
-                          tapeAlphabet = tapeAlphabetResult.tapeAlphabet;
-                        },
-                        [&startState](
-                            const StartStateResult &startStateResult) {
-                          startState = startStateResult.startState;
-                        },
-                        [&finalStates](
-                            const FinalStatesResult &finalStatesResult) {
-                          finalStates = finalStatesResult.finalStates;
-                        },
-                        [&blankSymbol](
-                            const BlankSymbolResult &blankSymbolResult) {
-                          blankSymbol = blankSymbolResult.blankSymbol;
-                        },
-                        [&nTape](const NTapeResult &nTapeResult) {
-                          nTape = nTapeResult.nTape;
-                        }},
-                    normalStatementResult);
-              },
-              [&transitions](
-                  const TransitionStatementResult &transitionStatementResult) {
-                auto transition = transitionStatementResult.transition;
-                transitions[transition.oldState].emplace_back(transition);
-              },
-              [](const EmptyStatementResult &) {},
-              [](const CommentStatementResult &) {},
-          },
-          turing::parser::parseStatement(*statement));
-    }
-
-    return machine::Machine{states, inputAlphabet, tapeAlphabet, startState, blankSymbol, finalStates, nTape, transitions};
-  }
+  turing::machine::Machine parse();
 
 private:
-  const std::vector<std::string> statements_;
-  size_t index_;
+  const std::string source_;
+  std::string_view rest_; // statements not parsed yet
+  std::pmr::monotonic_buffer_resource arena_;
+  StringTable names_;
 
-  std::optional<std::string> nextStatement();
+  std::optional<std::string_view> nextStatement();
 };
 
 turing::machine::Machine parse(const std::string &filepath);
 
-} // namespace turing::parser
\ No newline at end of file
+} // namespace turing::parser
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
+#include <vector>
 
 #include "turing/machine/transition.h"
 
@@ -19,8 +22,11 @@ struct Result {
   std::unordered_map<std::string, turing::machine::Transition> transitions; // 状态函数 delta
 };
 
+// state names are interned in the StringTable of the StatementParser, other
+// views point into the parsed statement
+
 struct StatesResult {
-  std::unordered_set<std::string> states;
+  std::pmr::vector<std::string_view> states;
 };
 
 struct InputAlphabetResult {
@@ -32,11 +38,11 @@ struct TapeAlphabetResult {
 };
 
 struct StartStateResult {
-  std::string startState;
+  std::string_view startState;
 };
 
 struct FinalStatesResult {
-  std::unordered_set<std::string> finalStates;
+  std::pmr::vector<std::string_view> finalStates;
 };
 
 struct BlankSymbolResult {
@@ -50,7 +56,11 @@ struct NTapeResult {
 using NormalStatementResult = std::variant<StatesResult, InputAlphabetResult, TapeAlphabetResult, StartStateResult, FinalStatesResult, BlankSymbolResult, NTapeResult>;
 
 struct TransitionStatementResult {
-  turing::machine::Transition transition;
+  std::string_view oldState;
+  std::string_view oldSigns;
+  std::string_view newSigns;
+  std::string_view directions; // 'l', 'r', anything else stays
+  std::string_view newState;
 };
 
 struct EmptyStatementResult {};
@@ -3,17 +3,34 @@
 #include <cctype>
 #include <functional>
 #include <stdexcept>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 
 #include "turing/machine/direction.h"
 #include "turing/parser/exception.h"
 #include "turing/parser/result.h"
+#include "turing/parser/string_table.h"
 #include "turing/util/string.h"
 
 namespace turing::parser {
 
-StatementParser::StatementParser(std::string statement) : statement_(std::move(turing::util::string::trim(statement))), index_(0) {}
+namespace {
+std::string_view trim(std::string_view s) {
+  size_t start = s.find_first_not_of(turing::util::string::WHITESPACE);
+  if (start == std::string_view::npos) {
+    return {};
+  }
+  size_t end = s.find_last_not_of(turing::util::string::WHITESPACE);
+  return s.substr(start, end - start + 1);
+}
+} // namespace
+
+StatementParser::StatementParser(std::string_view statement,
+                                 StringTable &names,
+                                 std::pmr::memory_resource *arena)
+    : statement_(trim(statement)), index_(0), names_(names), arena_(arena) {}
 
 StatementResult StatementParser::parse() {
   if (isEmptyLine()) {
@@ -35,14 +52,14 @@ StatementResult StatementParser::parse() {
 StatesResult StatementParser::parseStates() {
   mustSkipLeftBracket();
   
-  std::unordered_set<std::string> states;
+  std::pmr::vector<std::string_view> states{arena_};
   
   do {
-    std::string state = this->mustNextToken();
+    std::string_view state = this->mustNextToken();
     if (state.empty()) {
       throw InvalidSyntaxException("should be a non-empty token");
     }
-    states.insert(state);
+    states.push_back(names_.intern(state));
     
     char ch = peekNextChar();
     if (ch == turing::util::string::RIGHT_BRACKET) {
@@ -56,7 +73,7 @@ StatesResult StatementParser::parseStates() {
   } while (true);
   
   return {
-    .states = states,
+    .states = std::move(states),
   };
 }
 
@@ -153,22 +170,22 @@ TapeAlphabetResult StatementParser::parseTapeAlphabet() {
 
 StartStateResult StatementParser::parseStartState() {
   return {
-    .startState = mustNextToken(),
+    .startState = names_.intern(mustNextToken()),
   };
 }
 
 FinalStatesResult StatementParser::parseFinalStates() {
   mustSkipLeftBracket();
 
-  std::unordered_set<std::string> states;
+  std::pmr::vector<std::string_view> states{arena_};
 
   do {
-    std::string state = mustNextToken();
+    std::string_view state = mustNextToken();
     
     if (state.empty()) {
       throw InvalidSyntaxException("should be a non-empty token");
     }
-    states.insert(state);
+    states.push_back(names_.intern(state));
 
     char ch = peekNextChar();
     if (ch == turing::util::string::RIGHT_BRACKET) {
@@ -182,7 +199,7 @@ FinalStatesResult StatementParser::parseFinalStates() {
   } while (true);
 
   return FinalStatesResult {
-      .finalStates = states,
+      .finalStates = std::move(states),
   };
 }
 
@@ -194,7 +211,7 @@ BlankSymbolResult StatementParser::parseBlankSymbol() {
 
 NTapeResult StatementParser::parseNTape() {
   return {
-      .nTape = turing::util::string::to_size_t(mustNextToken()),
+      .nTape = turing::util::string::to_size_t(std::string{mustNextToken()}),
   };
 }
 
@@ -228,60 +245,28 @@ turing::parser::NormalStatementResult turing::parser::StatementParser::parseNorm
 }
 
 TransitionStatementResult StatementParser::parseTransitionStatement() {
-  turing::machine::Transition transition {
-    .oldSigns   = std::vector<char>{},
-    .newSigns   = std::vector<char>{},
-    .directions = std::vector<turing::machine::Direction>{},
-  };
+  TransitionStatementResult result;
   
-  transition.oldState = mustNextToken();
+  result.oldState = names_.intern(mustNextToken());
   mustSkipSpace();
-  
-  std::function<void(std::vector<char> &)> readSigns = [this](std::vector<char> &signs) {
-    while (this->peekNextChar() != turing::util::string::SPACE) {
-      signs.push_back(this->mustNextChar());
-    }
-  };
-  
-  readSigns(transition.oldSigns);
+  result.oldSigns = mustNextWord();
   mustSkipSpace();
-  readSigns(transition.newSigns);
+  result.newSigns = mustNextWord();
   mustSkipSpace();
-  
-  static std::function<void(std::vector<turing::machine::Direction> &)> readDirections = [this](std::vector<turing::machine::Direction> &directions) {
-    while (peekNextChar() != turing::util::string::SPACE) {
-      char ch = this->mustNextChar();
-      switch (ch){
-      case 'l':
-        directions.push_back(turing::machine::Direction::LEFT);
-        break;
-      case 'r':
-        directions.push_back(turing::machine::Direction::RIGHT);
-        break;
-      default:
-        directions.push_back(turing::machine::Direction::STAY);
-        break;
-      }
-    }
-  };
-  readDirections(transition.directions);
-  
+  result.directions = mustNextWord();
   mustSkipSpace();
-  transition.newState = mustNextToken();
+  result.newState = names_.intern(mustNextToken());
   
-  return {
-    .transition = transition,
-  };
+  return result;
 }
 
-std::string StatementParser::mustNextToken() {
-  std::string s;
+std::string_view StatementParser::mustNextToken() {
+  size_t start = index_;
   
   while (!reachEnd()) {
     char ch = peekNextChar();
     
     if (std::isalnum(ch) || ch == turing::util::string::UNDERSCORE) {
-      s += ch;
       mustNextChar();
       continue;
     }
@@ -289,7 +274,18 @@ std::string StatementParser::mustNextToken() {
     break;
   }
   
-  return s;
+  return statement_.substr(start, index_ - start);
+}
+
+// characters up to the next space
+std::string_view StatementParser::mustNextWord() {
+  size_t start = index_;
+  
+  while (peekNextChar() != turing::util::string::SPACE) {
+    mustNextChar();
+  }
+  
+  return statement_.substr(start, index_ - start);
 }
 
 char StatementParser::peekNextChar() const {
@@ -348,7 +344,35 @@ bool StatementParser::reachEnd() const {
   return statement_.size() == index_;
 }
 
-StatementResult parseStatement(const std::string &statement) {
-  return StatementParser{statement}.parse();
+StatementResult parseStatement(std::string_view statement, StringTable &names,
+                               std::pmr::memory_resource *arena) {
+  return StatementParser{statement, names, arena}.parse();
+}
+
+turing::machine::Transition toTransition(const TransitionStatementResult &result) {
+  turing::machine::Transition transition{
+    .oldState   = std::string{result.oldState},
+    .oldSigns   = std::vector<char>(result.oldSigns.begin(), result.oldSigns.end()),
+    .newSigns   = std::vector<char>(result.newSigns.begin(), result.newSigns.end()),
+    .directions = std::vector<turing::machine::Direction>{},
+    .newState   = std::string{result.newState},
+  };
+  
+  transition.directions.reserve(result.directions.size());
+  for (char ch : result.directions) {
+    switch (ch) {
+    case 'l':
+      transition.directions.push_back(turing::machine::Direction::LEFT);
+      break;
+    case 'r':
+      transition.directions.push_back(turing::machine::Direction::RIGHT);
+      break;
+    default:
+      transition.directions.push_back(turing::machine::Direction::STAY);
+      break;
+    }
+  }
+  
+  return transition;
 }
 }
\ No newline at end of file
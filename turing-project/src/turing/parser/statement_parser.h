@@ -1,19 +1,27 @@
 #pragma once
 
-#include <string>
+#include <memory_resource>
+#include <string_view>
 #include <unordered_set>
 
+#include "turing/machine/transition.h"
 #include "turing/parser/result.h"
+#include "turing/parser/string_table.h"
 
 namespace turing::parser {
+// Parses one line of a .tm file without copying it: results view the
+// statement, which must outlive them, and state names are interned in names.
 class StatementParser {
 public:
-  explicit StatementParser(std::string statement);
+  StatementParser(std::string_view statement, StringTable &names,
+                  std::pmr::memory_resource *arena);
   StatementResult parse();
 
 private:
-  const std::string statement_;
+  const std::string_view statement_;
   size_t index_;
+  StringTable &names_;
+  std::pmr::memory_resource *arena_;
 
   StatesResult parseStates();
   InputAlphabetResult parseInputAlphabet();
@@ -24,7 +32,8 @@ private:
   NTapeResult parseNTape();
   NormalStatementResult parseNormalStatement();
   TransitionStatementResult parseTransitionStatement();
-  std::string mustNextToken();
+  std::string_view mustNextToken();
+  std::string_view mustNextWord();
   char peekNextChar() const;
   char mustNextChar();
   void mustSkipSpace();
@@ -37,6 +46,9 @@ private:
   bool reachEnd() const;
 };
 
-StatementResult parseStatement(const std::string &statement);
+StatementResult parseStatement(std::string_view statement, StringTable &names,
+                               std::pmr::memory_resource *arena);
+
+turing::machine::Transition toTransition(const TransitionStatementResult &result);
 
 } // namespace turing::parser
@@ -0,0 +1,25 @@
+#include "turing/parser/string_table.h"
+
+#include <algorithm>
+#include <memory_resource>
+#include <string_view>
+
+namespace turing::parser {
+
+StringTable::StringTable(std::pmr::memory_resource *arena)
+    : arena_(arena), names_(arena) {}
+
+std::string_view StringTable::intern(std::string_view name) {
+  auto it = names_.find(name);
+  if (it != names_.end()) {
+    return *it;
+  }
+
+  char *data = static_cast<char *>(arena_->allocate(name.size(), 1));
+  std::copy(name.begin(), name.end(), data);
+  return *names_.emplace(data, name.size()).first;
+}
+
+size_t StringTable::size() const { return names_.size(); }
+
+} // namespace turing::parser
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_set>
+
+namespace turing::parser {
+
+// Interns state names into an arena. Each distinct name is stored once, so
+// two interned names are equal exactly when their data() pointers are.
+class StringTable {
+public:
+  explicit StringTable(std::pmr::memory_resource *arena);
+
+  std::string_view intern(std::string_view name);
+  size_t size() const;
+
+private:
+  std::pmr::memory_resource *arena_;
+  std::pmr::unordered_set<std::string_view> names_;
+};
+
+} // namespace turing::parser
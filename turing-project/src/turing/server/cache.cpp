@@ -0,0 +1,121 @@
+#include "turing/server/cache.h"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "turing/log/log.hpp"
+#include "turing/machine/machine.h"
+
+namespace turing::server {
+
+namespace {
+int64_t modificationTime(const std::string &path) {
+  struct stat st {};
+  if (::stat(path.c_str(), &st) != 0) {
+    throw std::invalid_argument("invalid filepath");
+  }
+  return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+         st.st_mtim.tv_nsec;
+}
+} // namespace
+
+MachineCache::MachineCache(size_t capacity, bool watch) : capacity_(capacity) {
+  if (watch) {
+    watcher_.emplace([this](const std::string &path) { reload(path); });
+  }
+}
+
+std::shared_ptr<const turing::machine::Machine>
+MachineCache::get(const std::string &path) {
+  // watched entries are reloaded on change, the others checked here
+  std::optional<int64_t> mtime;
+  if (!watcher_) {
+    mtime = modificationTime(path);
+  }
+
+  std::shared_ptr<Source> source;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(path);
+    if (it != index_.end()) {
+      if (!mtime || it->second->mtime == *mtime) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->machine;
+      }
+      source = it->second->source;
+    }
+  }
+
+  if (source == nullptr) {
+    source = std::make_shared<Source>(path);
+  }
+  return load(path, std::move(source));
+}
+
+std::shared_ptr<const turing::machine::Machine>
+MachineCache::load(const std::string &path, std::shared_ptr<Source> source) {
+  int64_t mtime = modificationTime(path);
+
+  // parse outside the cache lock so a slow parse does not stall cache hits
+  std::shared_ptr<const turing::machine::Machine> machine;
+  {
+    std::lock_guard<std::mutex> lock(source->mutex);
+    machine = std::make_shared<const turing::machine::Machine>(
+        source->parser.parse());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(path);
+  if (it != index_.end()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+  } else if (watcher_) {
+    try {
+      watcher_->watch(path);
+    } catch (const std::runtime_error &e) {
+      turing::log::error("watch ", path, ": ", e.what());
+    }
+  }
+  entries_.push_front(Entry{
+      .path = path,
+      .mtime = mtime,
+      .machine = machine,
+      .source = std::move(source),
+  });
+  index_[path] = entries_.begin();
+
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().path);
+    entries_.pop_back();
+  }
+
+  return machine;
+}
+
+void MachineCache::reload(const std::string &path) {
+  std::shared_ptr<Source> source;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(path);
+    if (it == index_.end()) {
+      return;
+    }
+    source = it->second->source;
+  }
+
+  // a broken edit keeps serving the last good machine
+  try {
+    load(path, std::move(source));
+  } catch (const std::exception &e) {
+    turing::log::error("reload ", path, ": ", e.what());
+  }
+}
+
+} // namespace turing::server
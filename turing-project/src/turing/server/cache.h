@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "turing/machine/machine.h"
+#include "turing/parser/incremental_parser.h"
+#include "turing/server/watcher.h"
+
+namespace turing::server {
+
+// LRU cache of parsed machines keyed by file path. An entry is only reused
+// while the file's modification time is unchanged, so editing a .tm file
+// invalidates it on the next lookup. With watch, cached files are watched
+// instead and reloaded as soon as they change, so lookups skip the stat.
+//
+// A reload only re-parses the lines that changed and publishes the new
+// machine atomically: runs that already got the old one finish on it.
+class MachineCache {
+public:
+  explicit MachineCache(size_t capacity, bool watch = false);
+
+  std::shared_ptr<const turing::machine::Machine> get(const std::string &path);
+
+private:
+  // the parser keeping the lines of a file, one reload at a time
+  struct Source {
+    std::mutex mutex;
+    turing::parser::IncrementalParser parser;
+
+    explicit Source(const std::string &path) : parser(path) {}
+  };
+
+  struct Entry {
+    std::string path;
+    int64_t mtime;
+    std::shared_ptr<const turing::machine::Machine> machine;
+    std::shared_ptr<Source> source;
+  };
+
+  const size_t capacity_;
+  std::list<Entry> entries_; // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  std::mutex mutex_;
+  std::optional<Watcher> watcher_;
+
+  std::shared_ptr<const turing::machine::Machine>
+  load(const std::string &path, std::shared_ptr<Source> source);
+  void reload(const std::string &path);
+};
+
+} // namespace turing::server
@@ -0,0 +1,258 @@
+#include "turing/server/server.h"
+
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/scheduler.h"
+#include "turing/util/json.h"
+
+namespace turing::server {
+
+namespace {
+
+namespace json = turing::util::json;
+
+constexpr double MAX_EXACT_ID = 9007199254740992.0; // 2^53
+
+const json::Value *member(const json::Object &object, const std::string &key) {
+  auto it = object.find(key);
+  return it == object.end() ? nullptr : &it->second;
+}
+
+const std::string &mustString(const json::Object &object,
+                              const std::string &key) {
+  const json::Value *value = member(object, key);
+  if (value == nullptr || !std::holds_alternative<std::string>(value->data)) {
+    throw std::invalid_argument("\"" + key + "\" should be a string");
+  }
+  return std::get<std::string>(value->data);
+}
+
+size_t maxSteps(const json::Object &request) {
+  const json::Value *options = member(request, "options");
+  if (options == nullptr) {
+    return std::numeric_limits<size_t>::max();
+  }
+  if (!std::holds_alternative<json::Object>(options->data)) {
+    throw std::invalid_argument("\"options\" should be an object");
+  }
+
+  const json::Value *limit =
+      member(std::get<json::Object>(options->data), "maxSteps");
+  if (limit == nullptr) {
+    return std::numeric_limits<size_t>::max();
+  }
+  if (!std::holds_alternative<double>(limit->data) ||
+      std::get<double>(limit->data) < 0) {
+    throw std::invalid_argument("\"maxSteps\" should be a non-negative number");
+  }
+  // casting a double past the range of size_t is undefined, and such a
+  // limit is no limit anyway
+  double steps = std::get<double>(limit->data);
+  if (steps >= static_cast<double>(std::numeric_limits<size_t>::max())) {
+    return std::numeric_limits<size_t>::max();
+  }
+  return static_cast<size_t>(steps);
+}
+
+std::string renderId(const json::Object &request) {
+  const json::Value *id = member(request, "id");
+  if (id == nullptr) {
+    return "";
+  }
+  if (std::holds_alternative<std::string>(id->data)) {
+    return "\"id\":" + json::quote(std::get<std::string>(id->data)) + ",";
+  }
+  // integers past 2^53 are not exact as doubles, so they could not be echoed
+  // back as sent
+  if (std::holds_alternative<double>(id->data)) {
+    double number = std::get<double>(id->data);
+    if (std::trunc(number) != number || std::fabs(number) > MAX_EXACT_ID) {
+      throw std::invalid_argument(
+          "\"id\" should be a string or an integer within +-2^53");
+    }
+    return "\"id\":" + std::to_string(static_cast<long long>(number)) + ",";
+  }
+  return "";
+}
+
+std::string error(const std::string &id, const std::string &message) {
+  return "{" + id + "\"error\":" + json::quote(message) + "}";
+}
+
+bool sendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += n;
+  }
+  return true;
+}
+
+} // namespace
+
+Server::Server(std::string socketPath, size_t cacheCapacity, bool watch)
+    : socketPath_(std::move(socketPath)), cache_(cacheCapacity, watch),
+      scheduler_(std::max(1u, std::thread::hardware_concurrency()),
+                 SCHEDULER_SLICE) {}
+
+void Server::serve() {
+  std::signal(SIGPIPE, SIG_IGN);
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath_.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("socket path too long");
+  }
+  std::strncpy(address.sun_path, socketPath_.c_str(),
+               sizeof(address.sun_path) - 1);
+
+  int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+
+  ::unlink(socketPath_.c_str());
+  if (::bind(listener, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listener, SOMAXCONN) != 0) {
+    std::string message = std::strerror(errno);
+    ::close(listener);
+    throw std::runtime_error(message);
+  }
+
+  while (true) {
+    int fd = ::accept(listener, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      std::string message = std::strerror(errno);
+      ::close(listener);
+      throw std::runtime_error(message);
+    }
+
+    std::thread([this, fd]() { handle(fd); }).detach();
+  }
+}
+
+void Server::handle(int fd) {
+  std::string buffer;
+  char chunk[4096];
+
+  while (true) {
+    ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    buffer.append(chunk, n);
+
+    size_t start = 0;
+    for (size_t end = buffer.find('\n'); end != std::string::npos;
+         start = end + 1, end = buffer.find('\n', start)) {
+      std::string line = buffer.substr(start, end - start);
+      if (line.find_first_not_of(" \r\t") == std::string::npos) {
+        continue;
+      }
+      if (!sendAll(fd, respond(line) + "\n")) {
+        ::close(fd);
+        return;
+      }
+    }
+    buffer.erase(0, start);
+  }
+
+  ::close(fd);
+}
+
+std::string Server::respond(const std::string &line) {
+  json::Object request;
+  try {
+    json::Value value = json::parse(line);
+    if (!std::holds_alternative<json::Object>(value.data)) {
+      return error("", "request should be a json object");
+    }
+    request = std::move(std::get<json::Object>(value.data));
+  } catch (const std::invalid_argument &e) {
+    return error("", e.what());
+  }
+
+  std::string id;
+  try {
+    id = renderId(request);
+  } catch (const std::invalid_argument &e) {
+    return error("", e.what());
+  }
+
+  try {
+    const std::string &input = mustString(request, "input");
+    size_t limit = maxSteps(request);
+    auto machine = cache_.get(mustString(request, "tm"));
+
+    auto validResult = machine->isInputValid(input);
+    if (std::holds_alternative<size_t>(validResult)) {
+      return "{" + id + "\"error\":\"illegal input string\",\"index\":" +
+             std::to_string(std::get<size_t>(validResult)) + "}";
+    }
+
+    auto response = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> result = response->get_future();
+    scheduler_.submit(
+        std::make_unique<turing::machine::Execution>(*machine, input),
+        [id, response](std::unique_ptr<turing::machine::Execution> execution,
+                       std::exception_ptr failure) {
+          if (failure) {
+            response->set_exception(failure);
+            return;
+          }
+
+          const turing::machine::Tapes &tapes = execution->tapes();
+          if (!execution->isHalted()) {
+            response->set_value(
+                "{" + id + "\"error\":\"step limit exceeded\",\"steps\":" +
+                std::to_string(tapes.steps()) + "}");
+            return;
+          }
+
+          response->set_value(
+              "{" + id + "\"accepted\":" +
+              (tapes.isAccepted() ? "true" : "false") +
+              ",\"result\":" + json::quote(tapes.content().value_or("")) +
+              ",\"steps\":" + std::to_string(tapes.steps()) + "}");
+        },
+        limit);
+
+    // the machine stays cached by this frame until the run is done
+    return result.get();
+  } catch (const std::exception &e) {
+    return error(id, e.what());
+  }
+}
+
+} // namespace turing::server
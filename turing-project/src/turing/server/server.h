@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include "turing/machine/scheduler.h"
+#include "turing/server/cache.h"
+
+namespace turing::server {
+
+// Serve machine runs over a Unix domain socket. Every line a client sends is
+// one JSON request
+//
+//   {"id": 1, "tm": "programs/case1.tm", "input": "aabb",
+//    "options": {"maxSteps": 100000}}
+//
+// and is answered by one JSON line carrying the same id. Connections are
+// served concurrently, requests on one connection in order. Runs share one
+// Scheduler with a worker per core, time-sliced so that long runs do not
+// hold up short ones. With watch, machine files are reloaded as soon as they
+// change on disk.
+class Server {
+public:
+  Server(std::string socketPath, size_t cacheCapacity, bool watch = false);
+
+  // block accepting connections, throw std::runtime_error if the socket
+  // cannot be set up
+  void serve();
+
+  std::string respond(const std::string &request);
+
+private:
+  static constexpr size_t SCHEDULER_SLICE = 4096;
+
+  const std::string socketPath_;
+  MachineCache cache_;
+  turing::machine::Scheduler scheduler_;
+
+  void handle(int fd);
+};
+
+} // namespace turing::server
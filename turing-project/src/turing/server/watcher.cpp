@@ -0,0 +1,113 @@
+#include "turing/server/watcher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace turing::server {
+
+Watcher::Watcher(std::function<void(const std::string &)> onChange)
+    : onChange_(std::move(onChange)),
+      inotify_(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+      wakeup_(::eventfd(0, EFD_CLOEXEC)) {
+  if (inotify_ < 0 || wakeup_ < 0) {
+    std::string message = std::strerror(errno);
+    if (inotify_ >= 0) {
+      ::close(inotify_);
+    }
+    if (wakeup_ >= 0) {
+      ::close(wakeup_);
+    }
+    throw std::runtime_error(message);
+  }
+
+  thread_ = std::thread([this]() { loop(); });
+}
+
+Watcher::~Watcher() {
+  uint64_t one = 1;
+  while (::write(wakeup_, &one, sizeof(one)) < 0 && errno == EINTR) {
+  }
+  thread_.join();
+  ::close(inotify_);
+  ::close(wakeup_);
+}
+
+void Watcher::watch(const std::string &path) {
+  std::filesystem::path file{path};
+  std::string directory = file.parent_path().string();
+  if (directory.empty()) {
+    directory = ".";
+  }
+
+  int wd = ::inotify_add_watch(inotify_, directory.c_str(),
+                               IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (wd < 0) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> &paths = files_[wd][file.filename().string()];
+  if (std::find(paths.begin(), paths.end(), path) == paths.end()) {
+    paths.push_back(path);
+  }
+}
+
+void Watcher::loop() {
+  alignas(inotify_event) char buffer[4096];
+  pollfd fds[2] = {{.fd = inotify_, .events = POLLIN},
+                   {.fd = wakeup_, .events = POLLIN}};
+
+  while (true) {
+    if (::poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    if (fds[1].revents != 0) {
+      return;
+    }
+
+    ssize_t n = ::read(inotify_, buffer, sizeof(buffer));
+    if (n <= 0) {
+      continue;
+    }
+
+    // collect first, so onChange runs without the lock
+    std::vector<std::string> changed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (ssize_t offset = 0; offset < n;) {
+        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        auto directory = files_.find(event->wd);
+        if (event->len == 0 || directory == files_.end()) {
+          continue;
+        }
+        auto file = directory->second.find(event->name);
+        if (file != directory->second.end()) {
+          changed.insert(changed.end(), file->second.begin(), file->second.end());
+        }
+      }
+    }
+
+    for (const std::string &path : changed) {
+      onChange_(path);
+    }
+  }
+}
+
+} // namespace turing::server
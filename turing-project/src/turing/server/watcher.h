@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace turing::server {
+
+// Watches files with inotify and calls onChange with the path of a watched
+// file, from a thread of its own, once it is written or replaced. The
+// directory is watched rather than the file, since editors often save by
+// renaming a new file over the old one.
+class Watcher {
+public:
+  // throw std::runtime_error if inotify is not available
+  explicit Watcher(std::function<void(const std::string &)> onChange);
+  ~Watcher();
+
+  Watcher(const Watcher &) = delete;
+  Watcher &operator=(const Watcher &) = delete;
+
+  void watch(const std::string &path);
+
+private:
+  std::function<void(const std::string &)> onChange_;
+  int inotify_;
+  int wakeup_; // eventfd stopping the thread
+  std::mutex mutex_;
+  // watch descriptor -> file name in the directory -> watched paths
+  std::unordered_map<int,
+                     std::unordered_map<std::string, std::vector<std::string>>>
+      files_;
+  std::thread thread_;
+
+  void loop();
+};
+
+} // namespace turing::server
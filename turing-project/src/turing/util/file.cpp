@@ -2,7 +2,14 @@
 
 #include <exception>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 std::vector<std::string> turing::util::file::readLines(std::string filepath) {
   std::ifstream file(filepath);
@@ -19,4 +26,53 @@ std::vector<std::string> turing::util::file::readLines(std::string filepath) {
   }
 
   return lines;
-}
\ No newline at end of file
+}
+
+std::string turing::util::file::read(const std::string &filepath) {
+  std::ifstream file(filepath, std::ios::binary);
+
+  if (!file.is_open()) {
+    throw std::invalid_argument("invalid filepath");
+  }
+
+  std::ostringstream content;
+  content << file.rdbuf();
+  return std::move(content).str();
+}
+
+turing::util::file::MappedFile::MappedFile(const std::string &filepath)
+    : data_(nullptr), size_(0) {
+  int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::invalid_argument("invalid filepath");
+  }
+
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::invalid_argument("invalid filepath");
+  }
+
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ > 0) {
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);
+
+  if (data_ == MAP_FAILED) {
+    throw std::invalid_argument("cannot map file");
+  }
+  if (data_ != nullptr) {
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+}
+
+turing::util::file::MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+}
+
+std::string_view turing::util::file::MappedFile::view() const {
+  return {static_cast<const char *>(data_), size_};
+}
@@ -1,8 +1,28 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace turing::util::file {
 std::vector<std::string> readLines(std::string filepath);
-}
\ No newline at end of file
+// whole content of a file, in one buffer
+std::string read(const std::string &filepath);
+
+// read-only memory mapping of a whole file
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  std::string_view view() const;
+
+private:
+  void *data_;
+  size_t size_;
+};
+}
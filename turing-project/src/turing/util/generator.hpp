@@ -0,0 +1,110 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace turing::util {
+
+// Minimal lazy generator. Values are yielded by reference: a co_yield hands
+// out the address of its operand, which stays valid until the next resume.
+template <typename T> class Generator {
+public:
+  using value_type = std::remove_cvref_t<T>;
+  using reference = const value_type &;
+
+  struct promise_type {
+    const value_type *value = nullptr;
+    std::exception_ptr exception;
+
+    Generator get_return_object() {
+      return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    std::suspend_always yield_value(reference v) noexcept {
+      value = std::addressof(v);
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Generator::value_type;
+
+    iterator() = default;
+    explicit iterator(Generator *generator) : generator_(generator) {}
+
+    reference operator*() const { return generator_->value(); }
+    iterator &operator++() {
+      if (!generator_->next()) {
+        generator_ = nullptr;
+      }
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+    bool operator==(std::default_sentinel_t) const {
+      return generator_ == nullptr;
+    }
+
+  private:
+    Generator *generator_ = nullptr;
+  };
+
+  Generator() = default;
+  Generator(Generator &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  Generator &operator=(Generator &&other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  Generator(const Generator &) = delete;
+  Generator &operator=(const Generator &) = delete;
+  ~Generator() { destroy(); }
+
+  // resume until the next co_yield, return false once the coroutine is
+  // done. An exception escaping the coroutine is rethrown here.
+  bool next() {
+    if (handle_ == nullptr || handle_.done()) {
+      return false;
+    }
+    handle_.resume();
+    if (handle_.promise().exception) {
+      std::rethrow_exception(std::exchange(handle_.promise().exception, nullptr));
+    }
+    return !handle_.done();
+  }
+
+  reference value() const { return *handle_.promise().value; }
+
+  iterator begin() {
+    iterator it{this};
+    return next() ? it : iterator{};
+  }
+  std::default_sentinel_t end() const { return {}; }
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+
+  explicit Generator(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  void destroy() {
+    if (handle_ != nullptr) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+};
+
+} // namespace turing::util
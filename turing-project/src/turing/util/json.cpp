@@ -0,0 +1,293 @@
+#include "turing/util/json.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace turing::util::json {
+
+namespace {
+
+// arrays and objects nested deeper are rejected before they exhaust the stack
+constexpr size_t MAX_DEPTH = 256;
+
+class JsonParser {
+public:
+  explicit JsonParser(const std::string &text)
+      : text_(text), index_(0), depth_(0) {}
+
+  Value parse() {
+    Value value = parseValue();
+    skipWhitespace();
+    if (!reachEnd()) {
+      throw std::invalid_argument("trailing characters after json value");
+    }
+    return value;
+  }
+
+private:
+  const std::string &text_;
+  size_t index_;
+  size_t depth_; // arrays and objects open around index_
+
+  Value parseValue() {
+    skipWhitespace();
+    switch (peekNextChar()) {
+    case '{':
+      return {parseObject()};
+    case '[':
+      return {parseArray()};
+    case '"':
+      return {parseString()};
+    case 't':
+      mustSkipLiteral("true");
+      return {true};
+    case 'f':
+      mustSkipLiteral("false");
+      return {false};
+    case 'n':
+      mustSkipLiteral("null");
+      return {nullptr};
+    default:
+      return {parseNumber()};
+    }
+  }
+
+  Object parseObject() {
+    Object object;
+
+    mustSkip('{');
+    enter();
+    skipWhitespace();
+    if (peekNextChar() == '}') {
+      mustNextChar();
+      --depth_;
+      return object;
+    }
+
+    do {
+      skipWhitespace();
+      std::string key = parseString();
+      skipWhitespace();
+      mustSkip(':');
+      object[key] = parseValue();
+      skipWhitespace();
+    } while (skipIf(','));
+    mustSkip('}');
+    --depth_;
+
+    return object;
+  }
+
+  Array parseArray() {
+    Array array;
+
+    mustSkip('[');
+    enter();
+    skipWhitespace();
+    if (peekNextChar() == ']') {
+      mustNextChar();
+      --depth_;
+      return array;
+    }
+
+    do {
+      array.push_back(parseValue());
+      skipWhitespace();
+    } while (skipIf(','));
+    mustSkip(']');
+    --depth_;
+
+    return array;
+  }
+
+  std::string parseString() {
+    std::string s;
+
+    mustSkip('"');
+    for (char ch = mustNextChar(); ch != '"'; ch = mustNextChar()) {
+      if (ch != '\\') {
+        s += ch;
+        continue;
+      }
+      switch (mustNextChar()) {
+      case '"':
+        s += '"';
+        break;
+      case '\\':
+        s += '\\';
+        break;
+      case '/':
+        s += '/';
+        break;
+      case 'b':
+        s += '\b';
+        break;
+      case 'f':
+        s += '\f';
+        break;
+      case 'n':
+        s += '\n';
+        break;
+      case 'r':
+        s += '\r';
+        break;
+      case 't':
+        s += '\t';
+        break;
+      case 'u':
+        appendCodePoint(s, parseHex4());
+        break;
+      default:
+        throw std::invalid_argument("invalid escape in json string");
+      }
+    }
+
+    return s;
+  }
+
+  double parseNumber() {
+    size_t start = index_;
+    while (!reachEnd() && (isDigit(text_[index_]) || text_[index_] == '-' ||
+                           text_[index_] == '+' || text_[index_] == '.' ||
+                           text_[index_] == 'e' || text_[index_] == 'E')) {
+      ++index_;
+    }
+    if (start == index_) {
+      throw std::invalid_argument("unexpected character in json");
+    }
+
+    std::string number = text_.substr(start, index_ - start);
+    char *end = nullptr;
+    double value = std::strtod(number.c_str(), &end);
+    if (end != number.c_str() + number.size()) {
+      throw std::invalid_argument("invalid json number");
+    }
+    return value;
+  }
+
+  unsigned parseHex4() {
+    unsigned codePoint = 0;
+    for (int i = 0; i < 4; ++i) {
+      unsigned char ch = static_cast<unsigned char>(mustNextChar());
+      if (!std::isxdigit(ch)) {
+        throw std::invalid_argument("invalid \\u escape in json string");
+      }
+      codePoint = codePoint * 16 +
+                  (std::isdigit(ch) ? ch - '0' : std::tolower(ch) - 'a' + 10);
+    }
+    return codePoint;
+  }
+
+  static void appendCodePoint(std::string &s, unsigned codePoint) {
+    if (codePoint < 0x80) {
+      s += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+      s += static_cast<char>(0xC0 | (codePoint >> 6));
+      s += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+      s += static_cast<char>(0xE0 | (codePoint >> 12));
+      s += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      s += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+  }
+
+  void skipWhitespace() {
+    while (!reachEnd() && isSpace(text_[index_])) {
+      ++index_;
+    }
+  }
+
+  // <cctype> is undefined for negative chars, i.e. bytes past ASCII
+  static bool isDigit(char ch) {
+    return std::isdigit(static_cast<unsigned char>(ch));
+  }
+
+  static bool isSpace(char ch) {
+    return std::isspace(static_cast<unsigned char>(ch));
+  }
+
+  void enter() {
+    if (++depth_ > MAX_DEPTH) {
+      throw std::invalid_argument("json nested too deeply");
+    }
+  }
+
+  bool skipIf(char expected) {
+    if (!reachEnd() && text_[index_] == expected) {
+      ++index_;
+      return true;
+    }
+    return false;
+  }
+
+  void mustSkip(char expected) {
+    if (mustNextChar() != expected) {
+      throw std::invalid_argument(std::string{"json should have a "} + expected);
+    }
+  }
+
+  void mustSkipLiteral(const std::string &literal) {
+    for (char expected : literal) {
+      mustSkip(expected);
+    }
+  }
+
+  char peekNextChar() const {
+    if (reachEnd()) {
+      throw std::invalid_argument("unexpected end of json");
+    }
+    return text_[index_];
+  }
+
+  char mustNextChar() {
+    if (reachEnd()) {
+      throw std::invalid_argument("unexpected end of json");
+    }
+    return text_[index_++];
+  }
+
+  bool reachEnd() const { return index_ == text_.size(); }
+};
+
+} // namespace
+
+Value parse(const std::string &text) { return JsonParser{text}.parse(); }
+
+std::string quote(const std::string &s) {
+  std::string quoted = "\"";
+
+  for (char ch : s) {
+    switch (ch) {
+    case '"':
+      quoted += "\\\"";
+      break;
+    case '\\':
+      quoted += "\\\\";
+      break;
+    case '\n':
+      quoted += "\\n";
+      break;
+    case '\r':
+      quoted += "\\r";
+      break;
+    case '\t':
+      quoted += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(ch) < 0x20) {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+        quoted += escaped;
+      } else {
+        quoted += ch;
+      }
+    }
+  }
+
+  return quoted + "\"";
+}
+
+} // namespace turing::util::json
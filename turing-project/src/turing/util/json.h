@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace turing::util::json {
+
+struct Value;
+
+using Null = std::nullptr_t;
+using Array = std::vector<Value>;
+using Object = std::map<std::string, Value>;
+
+struct Value {
+  std::variant<Null, bool, double, std::string, Array, Object> data;
+};
+
+// parse one JSON document, throw std::invalid_argument on malformed text
+Value parse(const std::string &text);
+
+// render s as a JSON string literal, quotes included
+std::string quote(const std::string &s);
+
+} // namespace turing::util::json
@@ -2,11 +2,20 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 
 namespace turing::util::number {
 
-constexpr size_t length(const int num) {
+constexpr size_t length(const int64_t num) {
   return num == 0 ? 1 : (num < 0 ? static_cast<size_t>(log10(std::abs(num))) + 1 : static_cast<size_t>(log10(num)) + 1);
 }
 
+// splitmix64, a cheap stateless mix of a counter into a random word
+constexpr uint64_t mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
 }
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace turing::util {
+
+// Lock-free ring buffer for one producer and one consumer. It holds no
+// pointers, so it also works between processes when placed in shared memory.
+template <typename T, size_t N> class Ring {
+  static_assert((N & (N - 1)) == 0, "N should be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+public:
+  // producer side, false when full
+  bool push(const T &item) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == N) {
+      return false;
+    }
+    items_[head % N] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer side, false when empty
+  bool pop(T &item) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_.load(std::memory_order_acquire) == tail) {
+      return false;
+    }
+    item = items_[tail % N];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  // only while neither side uses the ring
+  void clear() {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) T items_[N];
+};
+
+} // namespace turing::util
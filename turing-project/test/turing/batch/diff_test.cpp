@@ -0,0 +1,126 @@
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "turing/batch/diff.h"
+#include "turing/machine/direction.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+
+using turing::batch::DiffReport;
+using turing::batch::Outcome;
+using turing::machine::Direction;
+using turing::machine::Machine;
+using turing::machine::Transition;
+
+// accepts inputs with a 1 in them, spins forever on the others
+Machine anyOne() {
+  return Machine{{"scan", "found", "spin"},
+                 {'0', '1'},
+                 {'0', '1', '_'},
+                 "scan",
+                 '_',
+                 {"found"},
+                 1,
+                 {{"scan",
+                   {Transition{"scan", {'0'}, {'0'}, {Direction::RIGHT}, "scan"},
+                    Transition{"scan", {'1'}, {'1'}, {Direction::STAY}, "found"},
+                    Transition{"scan", {'_'}, {'_'}, {Direction::STAY}, "spin"}}},
+                  {"spin",
+                   {Transition{"spin", {'_'}, {'_'}, {Direction::STAY}, "spin"}}}}};
+}
+
+// accepts inputs with a 1 in them and halts on the others. With mark, the
+// symbol after the first 1 is overwritten by an x when it is a 1 as well.
+Machine anyOneHalting(bool mark) {
+  std::vector<Transition> scan{
+      Transition{"scan", {'0'}, {'0'}, {Direction::RIGHT}, "scan"},
+      Transition{"scan", {'_'}, {'_'}, {Direction::STAY}, "reject"}};
+  if (!mark) {
+    scan.push_back(Transition{"scan", {'1'}, {'1'}, {Direction::STAY}, "found"});
+    return Machine{{"scan", "found", "reject"},
+                   {'0', '1'},
+                   {'0', '1', '_'},
+                   "scan",
+                   '_',
+                   {"found"},
+                   1,
+                   {{"scan", scan}}};
+  }
+
+  scan.push_back(Transition{"scan", {'1'}, {'1'}, {Direction::RIGHT}, "one"});
+  return Machine{
+      {"scan", "one", "found", "reject"},
+      {'0', '1'},
+      {'0', '1', 'x', '_'},
+      "scan",
+      '_',
+      {"found"},
+      1,
+      {{"scan", scan},
+       {"one",
+        {Transition{"one", {'0'}, {'0'}, {Direction::STAY}, "found"},
+         Transition{"one", {'1'}, {'x'}, {Direction::STAY}, "found"},
+         Transition{"one", {'_'}, {'_'}, {Direction::STAY}, "found"}}}}};
+}
+
+void testEquivalent() {
+  const Machine spinning = anyOne();
+  const Machine halting = anyOneHalting(false);
+  const size_t maxLength = 10;
+
+  DiffReport report = turing::batch::diff(
+      spinning, halting,
+      {.maxLength = maxLength, .randomInputs = 0, .seed = 0, .maxSteps = 100,
+       .nThread = 3});
+  // all-zero inputs, one per length, never halt on the spinning machine
+  assert(!report.input.has_value());
+  assert(report.undecided == maxLength + 1);
+  assert(report.checked + report.undecided == (size_t{2} << maxLength) - 1);
+
+  report = turing::batch::diff(
+      spinning, halting,
+      {.maxLength = maxLength, .randomInputs = 500, .seed = 7, .maxSteps = 100,
+       .nThread = 3});
+  assert(!report.input.has_value());
+  assert(report.checked + report.undecided == 500);
+}
+
+void testDifferent() {
+  const Machine plain = anyOneHalting(false);
+  const Machine marking = anyOneHalting(true);
+
+  // "", "0", "1", "00", "01" and "10" agree, "11" is the first that does not
+  for (size_t nThread : {1, 4}) {
+    DiffReport report = turing::batch::diff(
+        plain, marking,
+        {.maxLength = 8, .randomInputs = 0, .seed = 0, .maxSteps = 100,
+         .nThread = nThread});
+    assert(report.input == "11");
+    assert((report.left == Outcome{.halted = true, .accepted = true,
+                                   .content = "11"}));
+    assert((report.right == Outcome{.halted = true, .accepted = true,
+                                    .content = "1x"}));
+    assert(report.undecided == 0);
+    if (nThread == 1) {
+      assert(report.checked == 7);
+    }
+  }
+}
+
+void testRun() {
+  const Machine machine = anyOne();
+  assert((turing::batch::run(machine, "001", 100) ==
+          Outcome{.halted = true, .accepted = true, .content = "001"}));
+  assert((turing::batch::run(machine, "000", 100) ==
+          Outcome{.halted = false, .accepted = false, .content = ""}));
+  // a run cut short by the step budget is undecided too
+  assert(!turing::batch::run(machine, "001", 1).halted);
+}
+
+int main() {
+  testEquivalent();
+  testDifferent();
+  testRun();
+}
@@ -0,0 +1,57 @@
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "turing/batch/inputs.h"
+
+using turing::batch::RandomInputs;
+using turing::batch::ShortlexInputs;
+
+void testShortlex() {
+  ShortlexInputs inputs{{'a', 'b'}, 2};
+  assert(inputs.size() == 7);
+
+  std::vector<std::string> all;
+  std::string input;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs.at(i, input);
+    all.push_back(input);
+  }
+  assert((all == std::vector<std::string>{"", "a", "b", "aa", "ab", "ba", "bb"}));
+
+  std::string walked;
+  inputs.at(0, walked);
+  for (size_t i = 1; i < inputs.size(); ++i) {
+    inputs.next(walked);
+    assert(walked == all[i]);
+  }
+
+  ShortlexInputs empty{{}, 5};
+  assert(empty.size() == 1);
+
+  try {
+    ShortlexInputs huge{{'a', 'b'}, 64};
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+}
+
+void testRandom() {
+  RandomInputs inputs{{'0', '1'}, 10, 100, 42};
+  assert(inputs.size() == 100);
+
+  std::string first, second;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs.at(i, first);
+    inputs.at(i, second);
+    assert(first == second);
+    assert(first.size() <= 10);
+    assert(first.find_first_not_of("01") == std::string::npos);
+  }
+}
+
+int main() {
+  testShortlex();
+  testRandom();
+}
@@ -0,0 +1,64 @@
+#include <cassert>
+#include <cstddef>
+
+#include "turing/batch/sweep.h"
+#include "turing/machine/direction.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+
+using turing::batch::SweepOption;
+using turing::batch::SweepReport;
+using turing::machine::Direction;
+using turing::machine::Machine;
+using turing::machine::Transition;
+
+// accepts inputs with a 1 in them, spins forever on the others
+Machine anyOne() {
+  return Machine{{"scan", "found", "spin"},
+                 {'0', '1'},
+                 {'0', '1', '_'},
+                 "scan",
+                 '_',
+                 {"found"},
+                 1,
+                 {{"scan",
+                   {Transition{"scan", {'0'}, {'0'}, {Direction::RIGHT}, "scan"},
+                    Transition{"scan", {'1'}, {'1'}, {Direction::STAY}, "found"},
+                    Transition{"scan", {'_'}, {'_'}, {Direction::STAY}, "spin"}}},
+                  {"spin",
+                   {Transition{"spin", {'_'}, {'_'}, {Direction::STAY}, "spin"}}}}};
+}
+
+int main() {
+  const Machine machine = anyOne();
+  const size_t maxLength = 12;
+
+  SweepReport threads = turing::batch::sweep(
+      machine, {.maxLength = maxLength, .maxSteps = 100, .nThread = 3});
+  SweepReport processes = turing::batch::sweep(
+      machine, {.maxLength = maxLength,
+                .maxSteps = 100,
+                .nThread = 3,
+                .processes = true});
+  SweepReport lockstep = turing::batch::sweep(
+      machine, {.maxLength = maxLength,
+                .maxSteps = 100,
+                .nThread = 3,
+                .lockstep = true});
+
+  // all-zero inputs, one per length, never halt
+  assert(threads.inputs == (size_t{2} << maxLength) - 1);
+  assert(threads.undecided == maxLength + 1);
+  assert(threads.accepted == threads.inputs - threads.undecided);
+
+  assert(processes.inputs == threads.inputs);
+  assert(processes.accepted == threads.accepted);
+  assert(processes.undecided == threads.undecided);
+  assert(processes.accepts == threads.accepts);
+  assert(processes.failed.empty());
+
+  assert(lockstep.inputs == threads.inputs);
+  assert(lockstep.accepted == threads.accepted);
+  assert(lockstep.undecided == threads.undecided);
+  assert(lockstep.accepts == threads.accepts);
+}
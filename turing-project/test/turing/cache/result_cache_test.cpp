@@ -0,0 +1,196 @@
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "turing/cache/result_cache.h"
+#include "turing/machine/direction.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+
+using turing::cache::Fingerprint;
+using turing::cache::ResultCache;
+using turing::machine::Direction;
+using turing::machine::Machine;
+using turing::machine::RunResult;
+using turing::machine::Transition;
+
+// writes x over the input and halts on the blank after it, or on a y when
+// stopAtY
+Machine writer(bool stopAtY = false) {
+  std::vector<Transition> transitions{
+      Transition{"write", {'1'}, {'x'}, {Direction::RIGHT}, "write"},
+      Transition{"write", {'_'}, {'_'}, {Direction::STAY}, "done"}};
+  if (stopAtY) {
+    transitions.push_back(
+        Transition{"write", {'y'}, {'y'}, {Direction::STAY}, "done"});
+  }
+  return Machine{{"write", "done"},
+                 {'1', 'y'},
+                 {'1', 'x', 'y', '_'},
+                 "write",
+                 '_',
+                 {"done"},
+                 1,
+                 {{"write", transitions}}};
+}
+
+std::string directory() {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "result_cache_test").string();
+  std::filesystem::remove_all(path);
+  return path;
+}
+
+std::string logOf(const std::string &directory) {
+  return (std::filesystem::path{directory} / "log").string();
+}
+
+void testFingerprint() {
+  const Machine machine = writer();
+  const Machine same = writer();
+  const Machine edited = writer(true);
+  assert(turing::cache::fingerprint(machine) ==
+         turing::cache::fingerprint(same));
+  assert(!(turing::cache::fingerprint(machine) ==
+           turing::cache::fingerprint(edited)));
+
+  // the order of the transitions of a state is part of the machine
+  const Machine swapped{
+      {"write", "done"},
+      {'1', 'y'},
+      {'1', 'x', 'y', '_'},
+      "write",
+      '_',
+      {"done"},
+      1,
+      {{"write",
+        {Transition{"write", {'_'}, {'_'}, {Direction::STAY}, "done"},
+         Transition{"write", {'1'}, {'x'}, {Direction::RIGHT}, "write"}}}}};
+  assert(!(turing::cache::fingerprint(machine) ==
+           turing::cache::fingerprint(swapped)));
+}
+
+void testHit() {
+  std::string path = directory();
+  const Fingerprint machine = turing::cache::fingerprint(writer());
+  const Fingerprint edited = turing::cache::fingerprint(writer(true));
+
+  {
+    ResultCache cache{path};
+    assert(!cache.find(machine, "111").has_value());
+    cache.store(machine, "111", {.accepted = true, .steps = 4, .content = "xxx"});
+    cache.store(machine, "", {.accepted = false, .steps = 0, .content = ""});
+    // storing a key again keeps the first record
+    cache.store(machine, "111", {.accepted = false, .steps = 9, .content = "?"});
+    assert(cache.size() == 2);
+
+    std::optional<RunResult> hit = cache.find(machine, "111");
+    assert(hit.has_value() && hit->accepted && hit->steps == 4 &&
+           hit->content == "xxx");
+    hit = cache.find(machine, "");
+    assert(hit.has_value() && !hit->accepted && hit->content.empty());
+    assert(!cache.find(machine, "11").has_value());
+    // another machine does not see the results of the first
+    assert(!cache.find(edited, "111").has_value());
+  }
+
+  // a new process finds what the last one stored
+  ResultCache cache{path};
+  assert(cache.size() == 2);
+  assert(cache.find(machine, "111")->content == "xxx");
+  std::filesystem::remove_all(path);
+}
+
+void testSharedLog() {
+  std::string path = directory();
+  const Fingerprint machine = turing::cache::fingerprint(writer());
+
+  // records appended by another cache are indexed by the next store
+  ResultCache first{path};
+  ResultCache second{path};
+  first.store(machine, "1", {.accepted = true, .steps = 2, .content = "x"});
+  second.store(machine, "11", {.accepted = true, .steps = 3, .content = "xx"});
+  assert(second.size() == 2);
+  assert(second.find(machine, "1")->content == "x");
+  std::filesystem::remove_all(path);
+}
+
+void testGrowth() {
+  std::string path = directory();
+  const Fingerprint machine = turing::cache::fingerprint(writer());
+
+  {
+    ResultCache cache{path};
+    std::string input;
+    for (size_t i = 0; i < 3000; ++i) {
+      input += '1';
+      cache.store(machine, input,
+                  {.accepted = true, .steps = i + 2, .content = input});
+    }
+    assert(cache.size() == 3000);
+    assert(cache.find(machine, std::string(1234, '1'))->steps == 1235);
+  }
+
+  // an index that was lost is rebuilt from the log
+  std::filesystem::remove(std::filesystem::path{path} / "index");
+  ResultCache cache{path};
+  assert(cache.size() == 3000);
+  assert(cache.find(machine, std::string(3000, '1'))->steps == 3001);
+  std::filesystem::remove_all(path);
+}
+
+void testTornRecord() {
+  std::string path = directory();
+  const Fingerprint machine = turing::cache::fingerprint(writer());
+
+  {
+    ResultCache cache{path};
+    cache.store(machine, "1", {.accepted = true, .steps = 2, .content = "x"});
+  }
+  size_t size = std::filesystem::file_size(logOf(path));
+  {
+    ResultCache cache{path};
+    cache.store(machine, "11", {.accepted = true, .steps = 3, .content = "xx"});
+  }
+  // a writer died halfway through the second record
+  std::filesystem::resize_file(logOf(path), size + 20);
+  std::filesystem::remove(std::filesystem::path{path} / "index");
+
+  ResultCache cache{path};
+  assert(cache.size() == 1);
+  assert(std::filesystem::file_size(logOf(path)) == size);
+  assert(!cache.find(machine, "11").has_value());
+  cache.store(machine, "11", {.accepted = true, .steps = 3, .content = "xx"});
+  assert(cache.find(machine, "11")->content == "xx");
+  std::filesystem::remove_all(path);
+}
+
+void testNotACache() {
+  std::string path = directory();
+  std::filesystem::create_directories(path);
+  {
+    std::ofstream log{logOf(path)};
+    log << "something else entirely";
+  }
+
+  bool thrown = false;
+  try {
+    ResultCache cache{path};
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+  assert(thrown);
+  std::filesystem::remove_all(path);
+}
+
+int main() {
+  testFingerprint();
+  testHit();
+  testSharedLog();
+  testGrowth();
+  testTornRecord();
+  testNotACache();
+}
@@ -0,0 +1,141 @@
+#include <cassert>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "turing/debug/breakpoint.h"
+#include "turing/debug/debugger.h"
+#include "turing/machine/direction.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+
+using turing::debug::Debugger;
+using turing::machine::Direction;
+using turing::machine::Machine;
+using turing::machine::Transition;
+
+// moves the input from tape 0 to tape 1, then rewinds tape 1 and accepts
+Machine mover() {
+  return Machine{
+      {"move", "rewind", "accept"},
+      {'a', 'b'},
+      {'a', 'b', '_'},
+      "move",
+      '_',
+      {"accept"},
+      2,
+      {{"move",
+        {Transition{"move", {'a', '_'}, {'_', 'a'},
+                    {Direction::RIGHT, Direction::RIGHT}, "move"},
+         Transition{"move", {'b', '_'}, {'_', 'b'},
+                    {Direction::RIGHT, Direction::RIGHT}, "move"},
+         Transition{"move", {'_', '_'}, {'_', '_'},
+                    {Direction::STAY, Direction::LEFT}, "rewind"}}},
+       {"rewind",
+        {Transition{"rewind", {'_', '_'}, {'_', '_'},
+                    {Direction::STAY, Direction::RIGHT}, "accept"},
+         Transition{"rewind", {'_', '*'}, {'*', '*'},
+                    {Direction::STAY, Direction::LEFT}, "rewind"}}}}};
+}
+
+void testBreakpoints() {
+  const Machine machine = mover();
+  Debugger debugger{machine, "abba"};
+
+  debugger.breakpoints().onState("rewind");
+  assert(debugger.resume() == "state rewind");
+  assert(debugger.execution().tapes().steps() == 5);
+  // still in rewind, but not entering it again
+  assert(debugger.resume() == std::nullopt);
+  assert(debugger.execution().isHalted());
+
+  debugger.execution().seek(0);
+  debugger.breakpoints().clear();
+  debugger.breakpoints().onRead("b_");
+  assert(debugger.resume() == "read b_");
+  assert(debugger.execution().tapes().steps() == 1);
+
+  debugger.breakpoints().clear();
+  debugger.breakpoints().onRead("_b");
+  // read through the '*' pattern while rewinding
+  assert(debugger.resume() == "read _b");
+  assert(debugger.execution().tapes().steps() == 6);
+
+  debugger.breakpoints().clear();
+  debugger.breakpoints().onHead(1, 1);
+  debugger.breakpoints().onStep(9);
+  assert(debugger.resume() == "head 1 1");
+  assert(debugger.execution().tapes().steps() == 7);
+  assert(debugger.resume() == "step 9");
+
+  debugger.execution().seek(0);
+  debugger.breakpoints().clear();
+  debugger.breakpoints().onFire("rewind", "__");
+  assert(debugger.resume() == "fire rewind __");
+  assert(debugger.execution().next()->newState == "accept");
+
+  try {
+    debugger.breakpoints().onState("nowhere");
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+  try {
+    debugger.breakpoints().onRead("a");
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+}
+
+void testRepl() {
+  const Machine machine = mover();
+  Debugger debugger{machine, "ab"};
+
+  std::istringstream in{"break state rewind\n"
+                        "c\n"
+                        "back 2\n"
+                        "bogus\n"
+                        "c\n"
+                        "c\n"
+                        "quit\n"
+                        "s\n"};
+  std::ostringstream out;
+  debugger.repl(in, out);
+
+  assert(out.str() == "(turing) "
+                      "(turing) Breakpoint state rewind\n"
+                      "Step 3, State rewind\n"
+                      "(turing) Step 1, State move\n"
+                      "(turing) error: unknown command, try help\n"
+                      "(turing) Breakpoint state rewind\n"
+                      "Step 3, State rewind\n"
+                      "(turing) Step 6, State accept, halted (ACCEPTED)\n"
+                      "(turing) ");
+}
+
+void testHeadIndex() {
+  const Machine machine = mover();
+  Debugger debugger{machine, "ab"};
+
+  // head indexes are 64-bit, as on the tapes
+  std::istringstream in{"break head 1 -5000000000\n"
+                        "break head 0 5000000000\n"
+                        "break head 0 99999999999999999999\n"
+                        "info\n"};
+  std::ostringstream out;
+  debugger.repl(in, out);
+
+  assert(out.str() ==
+         "(turing) "
+         "(turing) "
+         "(turing) error: expect a number, got \"99999999999999999999\"\n"
+         "(turing) 0: head 1 -5000000000\n"
+         "1: head 0 5000000000\n"
+         "(turing) ");
+}
+
+int main() {
+  testBreakpoints();
+  testRepl();
+  testHeadIndex();
+}
@@ -0,0 +1,96 @@
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "turing/gen/workload.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/parser/parser.hpp"
+
+using turing::gen::WorkloadOption;
+using turing::machine::Execution;
+using turing::machine::Machine;
+
+struct Outcome {
+  std::string input;
+  bool halted;
+  std::string content;
+};
+
+// generate kind, parse it back and run it on its input
+Outcome runWorkload(const std::string &kind, const WorkloadOption &option,
+                    size_t maxSteps = 1000000) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / ("workload_test_" + kind + ".tm");
+  std::ostringstream input;
+  {
+    std::ofstream tm{path};
+    turing::gen::generate(kind, option, tm, input);
+  }
+
+  const Machine machine = turing::parser::parse(path.string());
+  std::filesystem::remove(path);
+
+  assert(std::get<bool>(machine.isInputValid(input.str())));
+  Execution execution{machine, input.str()};
+  while (execution.tapes().steps() < maxSteps && execution.step()) {
+  }
+  return {
+      .input = input.str(),
+      .halted = execution.isHalted(),
+      .content = execution.tapes().content().value_or(""),
+  };
+}
+
+int main() {
+  const WorkloadOption option{.size = 13, .nTape = 4, .seed = 7};
+
+  Outcome counter = runWorkload("counter", option);
+  assert(counter.halted && counter.content == std::string(13, '1'));
+
+  Outcome copy = runWorkload("copy", option);
+  assert(copy.halted && copy.content == copy.input);
+  assert(copy.input.size() == 13);
+
+  Outcome reverse = runWorkload("reverse", option);
+  assert(reverse.halted);
+  assert(reverse.content == std::string(reverse.input.rbegin(),
+                                        reverse.input.rend()));
+
+  Outcome multiply = runWorkload("multiply", {.size = 5});
+  assert(multiply.halted && multiply.content == std::string(25, '1'));
+
+  Outcome shuffle = runWorkload("shuffle", option);
+  assert(shuffle.halted);
+  std::string dealt;
+  for (size_t tape = 0; tape < 3; ++tape) {
+    for (size_t i = tape; i < shuffle.input.size(); i += 3) {
+      dealt += shuffle.input[i];
+    }
+  }
+  assert(shuffle.content == dealt);
+
+  Outcome chain = runWorkload("chain", {.size = 1000, .seed = 3});
+  assert(chain.halted && chain.content.size() == 1000);
+
+  // beaver candidates may run forever, they only need to parse
+  runWorkload("beaver", {.size = 5, .seed = 1}, 1000);
+
+  // the same option gives the same program
+  std::ostringstream first, second, input;
+  turing::gen::generate("beaver", {.size = 6, .seed = 9}, first, input);
+  turing::gen::generate("beaver", {.size = 6, .seed = 9}, second, input);
+  assert(first.str() == second.str());
+  // on a blank tape
+  assert(input.str().empty());
+
+  try {
+    turing::gen::generate("nothing", option, first, input);
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+}
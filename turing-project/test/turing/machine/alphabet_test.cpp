@@ -0,0 +1,45 @@
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "turing/machine/alphabet.h"
+
+using turing::machine::Alphabet;
+
+size_t reference(const std::unordered_set<char> &symbols, std::string_view text) {
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (!symbols.contains(text[i])) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+int main() {
+  std::unordered_set<char> symbols = {'0', '1', 'a', 'z', '#', '~', '@'};
+  Alphabet alphabet{symbols};
+
+  for (int ch = 0; ch < 256; ++ch) {
+    assert(alphabet.contains(static_cast<char>(ch)) ==
+           symbols.contains(static_cast<char>(ch)));
+  }
+
+  assert(alphabet.findFirstNotOf("") == std::string_view::npos);
+  assert(alphabet.findFirstNotOf("01az#~@") == std::string_view::npos);
+  assert(alphabet.findFirstNotOf("0000000000000000000000000000001b") == 31);
+  assert(alphabet.findFirstNotOf("00000000000000000\xff") == 17);
+
+  std::srand(42);
+  const std::string pool = "01az#~@";
+  for (int round = 0; round < 1000; ++round) {
+    std::string text;
+    size_t size = std::rand() % 100;
+    for (size_t i = 0; i < size; ++i) {
+      text += std::rand() % 50 == 0 ? static_cast<char>(std::rand() % 256)
+                                    : pool[std::rand() % pool.size()];
+    }
+    assert(alphabet.findFirstNotOf(text) == reference(symbols, text));
+  }
+}
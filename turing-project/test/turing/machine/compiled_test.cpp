@@ -0,0 +1,165 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "turing/machine/compiled.hpp"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/symbols.h"
+#include "turing/parser/parser.hpp"
+
+using turing::machine::CompiledExecution;
+using turing::machine::CompiledMachine;
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::SymbolTable;
+
+// programs/palindrome_detector_2tapes.tm
+const char PALINDROME[] = R"(
+#Q = {0,cp,cmp,mh,accept,accept2,accept3,accept4,halt_accept,reject,reject2,reject3,reject4,reject5,halt_reject}
+#S = {0,1}
+#G = {0,1,_,t,r,u,e,f,a,l,s}
+#q0 = 0
+#B = _
+#F = {halt_accept}
+#N = 2
+
+0 0_ 0_ ** cp
+0 1_ 1_ ** cp
+0 __ __ ** accept
+
+cp 0_ 00 rr cp
+cp 1_ 11 rr cp
+cp __ __ ll mh
+
+mh 00 00 l* mh
+mh 01 01 l* mh
+mh 10 10 l* mh
+mh 11 11 l* mh
+mh _0 _0 r* cmp
+mh _1 _1 r* cmp
+
+cmp 00 __ rl cmp
+cmp 11 __ rl cmp
+cmp 01 __ rl reject
+cmp 10 __ rl reject
+cmp __ __ ** accept
+
+accept __ t_ r* accept2
+accept2 __ r_ r* accept3
+accept3 __ u_ r* accept4
+accept4 __ e_ ** halt_accept
+
+reject 00 __ rl reject
+reject 01 __ rl reject
+reject 10 __ rl reject
+reject 11 __ rl reject
+reject __ f_ r* reject2
+reject2 __ a_ r* reject3
+reject3 __ l_ r* reject4
+reject4 __ s_ r* reject5
+reject5 __ e_ ** halt_reject
+)";
+
+// the '*' pattern comes first, but exact transitions still win
+const char MARKER[] = R"(
+#Q = {scan,back,done}
+#S = {0,1}
+#G = {0,1,x,_}
+#q0 = scan
+#B = _
+#F = {done}
+#N = 1
+scan * * r scan
+scan 1 x r scan
+scan _ _ l back
+back * * l back
+back _ _ r done
+)";
+
+Machine parse(const char *source) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "compiled_test.tm";
+  {
+    std::ofstream tm{path};
+    tm << source;
+  }
+  Machine machine = turing::parser::parse(path.string());
+  std::filesystem::remove(path);
+  return machine;
+}
+
+void compare(const Machine &machine, const CompiledMachine &compiled,
+             const std::string &input, size_t maxSteps) {
+  Execution execution{machine, input};
+  while (execution.tapes().steps() < maxSteps && execution.step()) {
+  }
+
+  CompiledExecution run{compiled};
+  run.reset(input);
+  while (run.steps() < maxSteps && run.step()) {
+  }
+
+  assert(run.isHalted() == execution.isHalted());
+  assert(run.steps() == execution.tapes().steps());
+  assert(run.isAccepted() == execution.tapes().isAccepted());
+  assert(run.content() == execution.tapes().content());
+}
+
+// every binary input up to length 8
+void testAgainstExecution(const Machine &machine) {
+  const CompiledMachine compiled = turing::machine::compile(machine);
+  assert(compiled.nState() == 15);
+  assert(compiled.nTransition() == 30);
+
+  for (size_t length = 0; length <= 8; ++length) {
+    for (size_t bits = 0; bits < (size_t{1} << length); ++bits) {
+      std::string input;
+      for (size_t i = 0; i < length; ++i) {
+        input += (bits >> i & 1) ? '1' : '0';
+      }
+      compare(machine, compiled, input, 1000);
+      compare(machine, compiled, input, length);
+    }
+  }
+}
+
+void testSymbolTable() {
+  const Machine machine = parse(PALINDROME);
+  SymbolTable symbols{machine};
+
+  assert(symbols.size() == 11);
+  assert(symbols.code('_') == 0);
+  assert(symbols.symbol(0) == '_');
+  assert(symbols.code('*') == symbols.wildcard());
+  for (char symbol : std::string{"01truefals"}) {
+    assert(symbols.code(symbol) < symbols.size());
+    assert(symbols.symbol(symbols.code(symbol)) == symbol);
+  }
+}
+
+void testExactBeforePattern() {
+  const Machine machine = parse(MARKER);
+  const CompiledMachine compiled{machine, SymbolTable{machine}};
+
+  CompiledExecution run{compiled};
+  run.reset("0110");
+  while (run.step()) {
+  }
+  assert(run.isAccepted());
+  assert(run.content() == "0xx0");
+
+  compare(machine, compiled, "0110", 1000);
+  compare(machine, compiled, "", 1000);
+}
+
+int main() {
+  const Machine palindrome = parse(PALINDROME);
+  testAgainstExecution(palindrome);
+
+  testSymbolTable();
+  testExactBeforePattern();
+}
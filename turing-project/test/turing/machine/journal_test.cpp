@@ -0,0 +1,116 @@
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/journal.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::Journal;
+using turing::machine::Machine;
+using turing::machine::Transition;
+
+// moves the input from tape 0 to tape 1, then rewinds tape 1 and accepts
+Machine mover() {
+  return Machine{
+      {"move", "rewind", "accept"},
+      {'a', 'b'},
+      {'a', 'b', '_'},
+      "move",
+      '_',
+      {"accept"},
+      2,
+      {{"move",
+        {Transition{"move", {'a', '_'}, {'_', 'a'},
+                    {Direction::RIGHT, Direction::RIGHT}, "move"},
+         Transition{"move", {'b', '_'}, {'_', 'b'},
+                    {Direction::RIGHT, Direction::RIGHT}, "move"},
+         Transition{"move", {'_', '_'}, {'_', '_'},
+                    {Direction::STAY, Direction::LEFT}, "rewind"}}},
+       {"rewind",
+        {Transition{"rewind", {'_', '_'}, {'_', '_'},
+                    {Direction::STAY, Direction::RIGHT}, "accept"},
+         Transition{"rewind", {'_', '*'}, {'*', '*'},
+                    {Direction::STAY, Direction::LEFT}, "rewind"}}}}};
+}
+
+void testJournal() {
+  Journal journal{300, 2, 0};
+  assert(journal.bytesPerStep() == 4);
+
+  char signs[2];
+  for (size_t i = 0; i < 1000; ++i) {
+    signs[0] = static_cast<char>(i);
+    signs[1] = static_cast<char>(i >> 8);
+    journal.push(i % 300, signs);
+  }
+  assert(journal.size() == 1000);
+
+  for (size_t i = 1000; i > 0; --i) {
+    assert(journal.pop(signs) == (i - 1) % 300);
+    assert(signs[0] == static_cast<char>(i - 1));
+    assert(signs[1] == static_cast<char>((i - 1) >> 8));
+  }
+  assert(journal.empty());
+}
+
+void testRing() {
+  // two chunks at least, the oldest steps are dropped beyond that
+  Journal journal{2, 1, 0};
+  char sign = 'x';
+  size_t pushed = 0;
+  while (journal.size() == pushed) {
+    journal.push(1, &sign);
+    ++pushed;
+  }
+  assert(journal.size() < pushed);
+
+  size_t kept = journal.size();
+  for (size_t i = 0; i < kept; ++i) {
+    assert(journal.pop(&sign) == 1);
+  }
+  assert(journal.empty());
+}
+
+void testBack() {
+  const Machine machine = mover();
+
+  Execution execution{machine, "abba"};
+  execution.journal();
+  execution.tapes().trackHash();
+
+  std::vector<std::string> ids{execution.tapes().id()};
+  std::vector<uint64_t> hashes{execution.tapes().hash()};
+  while (execution.step()) {
+    ids.push_back(execution.tapes().id());
+    hashes.push_back(execution.tapes().hash());
+  }
+  assert(execution.tapes().isAccepted());
+  assert(execution.tapes().content() == std::nullopt);
+
+  for (size_t step = ids.size() - 1; step > 0; --step) {
+    assert(execution.back());
+    assert(execution.tapes().id() == ids[step - 1]);
+    assert(execution.tapes().hash() == hashes[step - 1]);
+  }
+  assert(!execution.back());
+  assert(!execution.tapes().isAccepted());
+  assert(execution.tapes().content() == "abba");
+
+  // replaying after going back reaches the same configurations
+  assert(execution.seek(7));
+  assert(execution.tapes().id() == ids[7]);
+  assert(execution.seek(3));
+  assert(execution.tapes().id() == ids[3]);
+  assert(!execution.seek(ids.size()));
+}
+
+int main() {
+  testJournal();
+  testRing();
+  testBack();
+}
@@ -0,0 +1,197 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "turing/machine/compiled.hpp"
+#include "turing/machine/direction.h"
+#include "turing/machine/lockstep.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/symbols.h"
+#include "turing/machine/transition.h"
+#include "turing/parser/parser.hpp"
+
+using turing::machine::Code;
+using turing::machine::CompiledExecution;
+using turing::machine::CompiledMachine;
+using turing::machine::Direction;
+using turing::machine::LockstepExecution;
+using turing::machine::LockstepTable;
+using turing::machine::Machine;
+using turing::machine::SymbolTable;
+using turing::machine::Transition;
+
+// programs/palindrome_detector_2tapes.tm
+const char PALINDROME[] = R"(
+#Q = {0,cp,cmp,mh,accept,accept2,accept3,accept4,halt_accept,reject,reject2,reject3,reject4,reject5,halt_reject}
+#S = {0,1}
+#G = {0,1,_,t,r,u,e,f,a,l,s}
+#q0 = 0
+#B = _
+#F = {halt_accept}
+#N = 2
+
+0 0_ 0_ ** cp
+0 1_ 1_ ** cp
+0 __ __ ** accept
+
+cp 0_ 00 rr cp
+cp 1_ 11 rr cp
+cp __ __ ll mh
+
+mh 00 00 l* mh
+mh 01 01 l* mh
+mh 10 10 l* mh
+mh 11 11 l* mh
+mh _0 _0 r* cmp
+mh _1 _1 r* cmp
+
+cmp 00 __ rl cmp
+cmp 11 __ rl cmp
+cmp 01 __ rl reject
+cmp 10 __ rl reject
+cmp __ __ ** accept
+
+accept __ t_ r* accept2
+accept2 __ r_ r* accept3
+accept3 __ u_ r* accept4
+accept4 __ e_ ** halt_accept
+
+reject 00 __ rl reject
+reject 01 __ rl reject
+reject 10 __ rl reject
+reject 11 __ rl reject
+reject __ f_ r* reject2
+reject2 __ a_ r* reject3
+reject3 __ l_ r* reject4
+reject4 __ s_ r* reject5
+reject5 __ e_ ** halt_reject
+)";
+
+// accepts inputs with a 1 in them, spins forever on the others
+Machine anyOne() {
+  return Machine{{"scan", "found", "spin"},
+                 {'0', '1'},
+                 {'0', '1', '_'},
+                 "scan",
+                 '_',
+                 {"found"},
+                 1,
+                 {{"scan",
+                   {Transition{"scan", {'0'}, {'0'}, {Direction::RIGHT}, "scan"},
+                    Transition{"scan", {'1'}, {'1'}, {Direction::STAY}, "found"},
+                    Transition{"scan", {'_'}, {'_'}, {Direction::STAY}, "spin"}}},
+                  {"spin",
+                   {Transition{"spin", {'*'}, {'*'}, {Direction::STAY}, "spin"}}}}};
+}
+
+Machine parse(const char *source) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "lockstep_test.tm";
+  {
+    std::ofstream tm{path};
+    tm << source;
+  }
+  Machine machine = turing::parser::parse(path.string());
+  std::filesystem::remove(path);
+  return machine;
+}
+
+// binary strings of length at most maxLength
+std::vector<std::string> binaryInputs(size_t maxLength) {
+  std::vector<std::string> inputs;
+  for (size_t length = 0; length <= maxLength; ++length) {
+    for (size_t bits = 0; bits < (size_t{1} << length); ++bits) {
+      std::string input;
+      for (size_t i = 0; i < length; ++i) {
+        input += (bits >> i & 1) ? '1' : '0';
+      }
+      inputs.push_back(input);
+    }
+  }
+  return inputs;
+}
+
+// 0 for undecided, 1 for rejected, 2 for accepted
+uint8_t verdict(bool halted, bool accepted) {
+  return halted ? 1 + accepted : 0;
+}
+
+// run every input in lockstep and on its own, return the runs the lockstep
+// one redid on the scalar path
+size_t compare(const Machine &machine, const std::vector<std::string> &inputs,
+               size_t window, size_t maxSteps, bool simd) {
+  const CompiledMachine compiled{machine, SymbolTable{machine}};
+  assert(LockstepTable::fits(compiled));
+  const LockstepTable table{compiled};
+
+  std::vector<uint8_t> expected;
+  CompiledExecution execution{compiled};
+  for (const std::string &input : inputs) {
+    execution.reset(input);
+    while (execution.steps() < maxSteps && execution.step()) {
+    }
+    expected.push_back(verdict(execution.isHalted(), execution.isAccepted()));
+  }
+
+  std::vector<uint8_t> actual(inputs.size(), 0xFF);
+  LockstepExecution lockstep{compiled, table, window, simd};
+  size_t next = 0;
+  lockstep.run(
+      inputs.size(), maxSteps,
+      [&](std::string &input) { input = inputs[next++]; },
+      [&](size_t i, bool halted, bool accepted) {
+        assert(actual[i] == 0xFF);
+        actual[i] = verdict(halted, accepted);
+      });
+  assert(next == inputs.size());
+  assert(actual == expected);
+  return lockstep.fallbacks();
+}
+
+void testPalindrome(bool simd) {
+  const Machine machine = parse(PALINDROME);
+  const std::vector<std::string> inputs = binaryInputs(10);
+
+  assert(compare(machine, inputs, 64, 100000, simd) == 0);
+  // runs cut short by the step budget are undecided, as on their own
+  assert(compare(machine, inputs, 64, 25, simd) == 0);
+  // heads writing past 16 cells, and inputs longer than 11, are redone
+  assert(compare(machine, inputs, 16, 100000, simd) > 0);
+}
+
+void testSpinning(bool simd) {
+  const Machine machine = anyOne();
+  const std::vector<std::string> inputs = binaryInputs(9);
+  assert(compare(machine, inputs, 64, 50, simd) == 0);
+}
+
+void testTable() {
+  const Machine machine = parse(PALINDROME);
+  const CompiledMachine compiled{machine, SymbolTable{machine}};
+  const LockstepTable table{compiled};
+
+  // every combination of codes under the heads picks what next() picks
+  const size_t nCode = compiled.symbols().size();
+  for (uint32_t state = 0; state < compiled.nState(); ++state) {
+    for (Code a = 0; a < nCode; ++a) {
+      for (Code b = 0; b < nCode; ++b) {
+        Code cells[] = {a, b};
+        uint32_t key = state * table.stateStride() + a * table.weights()[0] +
+                       b * table.weights()[1];
+        assert(table.actions()[key] == compiled.next(state, cells));
+      }
+    }
+  }
+}
+
+int main() {
+  testTable();
+  for (bool simd : {false, true}) {
+    testPalindrome(simd);
+    testSpinning(simd);
+  }
+}
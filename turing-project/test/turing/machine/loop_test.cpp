@@ -0,0 +1,94 @@
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/loop.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/transition.h"
+
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::LoopDetector;
+using turing::machine::Machine;
+using turing::machine::Transition;
+
+// walks right over the input, then bounces between the last two cells
+// flipping the last one forever
+Machine bouncer() {
+  return Machine{{"scan", "flip", "back"},
+                 {'1'},
+                 {'1', '0', '_'},
+                 "scan",
+                 '_',
+                 {},
+                 1,
+                 {{"scan",
+                   {Transition{"scan", {'1'}, {'1'}, {Direction::RIGHT}, "scan"},
+                    Transition{"scan", {'_'}, {'_'}, {Direction::LEFT}, "flip"}}},
+                  {"flip",
+                   {Transition{"flip", {'1'}, {'0'}, {Direction::RIGHT}, "back"},
+                    Transition{"flip", {'0'}, {'1'}, {Direction::RIGHT}, "back"}}},
+                  {"back",
+                   {Transition{"back", {'_'}, {'_'}, {Direction::LEFT}, "flip"}}}}};
+}
+
+void testDetector() {
+  // 0 1 2 3 4 5 3 4 5 ...
+  std::vector<uint64_t> sequence{0, 1, 2, 3, 4, 5};
+  for (int i = 0; i < 20; ++i) {
+    sequence.push_back(3 + i % 3);
+  }
+
+  LoopDetector detector{sequence[0]};
+  size_t i = 1;
+  while (!detector.observe(sequence[i])) {
+    ++i;
+    assert(i < sequence.size());
+  }
+  assert(detector.length() == 3);
+}
+
+void testHashTracksConfiguration() {
+  const Machine machine = bouncer();
+
+  // a hash kept up step by step equals one computed from scratch
+  Execution tracked{machine, "111"};
+  tracked.tapes().trackHash();
+  for (int i = 0; i < 12; ++i) {
+    tracked.step();
+    Execution fresh{machine, "111"};
+    for (int j = 0; j <= i; ++j) {
+      fresh.step();
+    }
+    fresh.tapes().trackHash();
+    assert(tracked.tapes().hash() == fresh.tapes().hash());
+  }
+}
+
+void testLoop() {
+  const Machine machine = bouncer();
+
+  Execution execution{machine, "111"};
+  execution.tapes().trackHash();
+  LoopDetector detector{execution.tapes().hash()};
+  while (execution.step() && !detector.observe(execution.tapes().hash())) {
+  }
+
+  assert(!execution.isHalted());
+  // flip, back, flip, back returns to the same cells and state
+  assert(detector.length() == 4);
+  // 4 steps scanning, then the cycle starts at the first flip
+  size_t steps = execution.tapes().steps();
+  assert(turing::machine::loopStart(machine, "111", detector.length(), steps) ==
+         4);
+  // no two configurations 3 steps apart are equal, whatever their hashes
+  assert(!turing::machine::loopStart(machine, "111", 3, steps).has_value());
+}
+
+int main() {
+  testDetector();
+  testHashTracksConfiguration();
+  testLoop();
+}
@@ -0,0 +1,211 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/observer.h"
+#include "turing/machine/tape.h"
+#include "turing/machine/transition.h"
+
+using turing::machine::DecideObserver;
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::LoopObserver;
+using turing::machine::Machine;
+using turing::machine::ProfileObserver;
+using turing::machine::Tapes;
+using turing::machine::TraceFileObserver;
+using turing::machine::Transition;
+
+// walks right over the input, then bounces between the last two cells
+// flipping the last one forever
+Machine bouncer() {
+  return Machine{{"scan", "flip", "back"},
+                 {'1'},
+                 {'1', '0', '_'},
+                 "scan",
+                 '_',
+                 {},
+                 1,
+                 {{"scan",
+                   {Transition{"scan", {'1'}, {'1'}, {Direction::RIGHT}, "scan"},
+                    Transition{"scan", {'_'}, {'_'}, {Direction::LEFT}, "flip"}}},
+                  {"flip",
+                   {Transition{"flip", {'1'}, {'0'}, {Direction::RIGHT}, "back"},
+                    Transition{"flip", {'0'}, {'1'}, {Direction::RIGHT}, "back"}}},
+                  {"back",
+                   {Transition{"back", {'_'}, {'_'}, {Direction::LEFT}, "flip"}}}}};
+}
+
+// writes x over the input and halts on the blank after it
+Machine writer() {
+  return Machine{{"write", "done"},
+                 {'1'},
+                 {'1', 'x', '_'},
+                 "write",
+                 '_',
+                 {"done"},
+                 1,
+                 {{"write",
+                   {Transition{"write", {'1'}, {'x'}, {Direction::RIGHT}, "write"},
+                    Transition{"write", {'_'}, {'_'}, {Direction::STAY}, "done"}}}}};
+}
+
+// accepts on a leading 1 and rejects on a leading 0, then runs right
+// forever either way
+Machine gate() {
+  return Machine{{"start", "done", "spin"},
+                 {'0', '1'},
+                 {'0', '1', '_'},
+                 "start",
+                 '_',
+                 {"done"},
+                 1,
+                 {{"start",
+                   {Transition{"start", {'1'}, {'1'}, {Direction::RIGHT}, "done"},
+                    Transition{"start", {'0'}, {'0'}, {Direction::RIGHT}, "spin"}}},
+                  {"done",
+                   {Transition{"done", {'*'}, {'*'}, {Direction::RIGHT}, "done"}}},
+                  {"spin",
+                   {Transition{"spin", {'*'}, {'*'}, {Direction::RIGHT}, "spin"}}}}};
+}
+
+// stops the run once it reaches a step
+class StopAt {
+public:
+  explicit StopAt(size_t step) : step_(step), calls_(0) {}
+
+  void before(const Transition &, const Tapes &) { ++calls_; }
+  bool after(const Transition &, const Execution &execution) {
+    return execution.tapes().steps() == step_;
+  }
+
+  size_t calls() const { return calls_; }
+
+private:
+  size_t step_;
+  size_t calls_;
+};
+
+std::string temporary(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void testNoObserver() {
+  const Machine machine = writer();
+  Execution execution{machine, "1111"};
+  assert(!turing::machine::observe(execution));
+  assert(execution.isHalted());
+  assert(execution.tapes().steps() == 5);
+  assert(execution.tapes().content() == "xxxx");
+}
+
+void testStop() {
+  const Machine machine = bouncer();
+  Execution execution{machine, "11"};
+  std::optional<StopAt> stop{std::in_place, 7};
+  std::optional<StopAt> unset;
+  assert(turing::machine::observe(execution, unset, stop));
+  assert(execution.tapes().steps() == 7);
+  assert(stop->calls() == 7);
+}
+
+void testLoop() {
+  const Machine machine = bouncer();
+  Execution execution{machine, "111"};
+  std::optional<LoopObserver> loop{std::in_place, execution.tapes()};
+  assert(turing::machine::observe(execution, loop));
+  assert(loop->length() == 4);
+}
+
+void testDecide() {
+  const Machine machine = gate();
+  assert(machine.canAccept("start") && machine.canAccept("done"));
+  assert(!machine.canAccept("spin"));
+
+  for (std::string input : {"1", "10", "0", "01"}) {
+    Execution execution{machine, input};
+    std::optional<DecideObserver> decide{std::in_place, machine,
+                                         execution.tapes()};
+    assert(!decide->decided());
+    assert(turing::machine::observe(execution, decide));
+    assert(decide->decided());
+    assert(execution.tapes().steps() == 1);
+    assert(execution.tapes().isAccepted() == (input[0] == '1'));
+  }
+
+  // halting undecided leaves the verdict to the halt
+  Execution blank{machine, ""};
+  std::optional<DecideObserver> decide{std::in_place, machine, blank.tapes()};
+  assert(!turing::machine::observe(blank, decide));
+  assert(!decide->decided() && !blank.tapes().isAccepted());
+
+  // without final states every run is rejected before its first step
+  const Machine loops = bouncer();
+  Execution execution{loops, "11"};
+  DecideObserver rejected{loops, execution.tapes()};
+  assert(rejected.decided() && !execution.tapes().isAccepted());
+}
+
+void testProfile() {
+  const Machine machine = writer();
+  std::string path = temporary("observer_test.profile");
+  Execution execution{machine, "111"};
+  std::optional<ProfileObserver> profile{std::in_place, machine, path};
+  std::optional<LoopObserver> loop{std::in_place, execution.tapes()};
+  assert(!turing::machine::observe(execution, profile, loop));
+  profile->finish();
+
+  const std::vector<uint64_t> &hits = profile->hits();
+  assert(std::accumulate(hits.begin(), hits.end(), uint64_t{0}) == 4);
+  for (size_t id = 0; id < machine.nTransition(); ++id) {
+    const Transition &transition = machine.transition(id);
+    assert(hits[id] == (transition.oldSigns[0] == '1' ? 3 : 1));
+  }
+
+  std::ifstream in{path};
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+  std::filesystem::remove(path);
+  assert(lines.size() == machine.nTransition());
+  for (const std::string &line : lines) {
+    assert(line == "3 write 1 x r write" || line == "1 write _ _ * done");
+  }
+}
+
+void testTraceFile() {
+  const Machine machine = writer();
+  std::string path = temporary("observer_test.trace");
+  {
+    Execution execution{machine, "11"};
+    std::optional<TraceFileObserver> trace{std::in_place, path};
+    turing::machine::observe(execution, trace);
+    trace->finish();
+  }
+
+  std::ifstream in{path};
+  std::string content{std::istreambuf_iterator<char>{in}, {}};
+  std::filesystem::remove(path);
+  assert(content == "1 write 1 x r write\n"
+                    "2 write 1 x r write\n"
+                    "3 write _ _ * done\n");
+}
+
+int main() {
+  testNoObserver();
+  testStop();
+  testLoop();
+  testDecide();
+  testProfile();
+  testTraceFile();
+}
@@ -0,0 +1,219 @@
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/persistent_tape.h"
+#include "turing/parser/parser.hpp"
+
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::PersistentTape;
+using turing::machine::PersistentTapes;
+
+// programs/palindrome_detector_2tapes.tm
+const char PALINDROME[] = R"(
+#Q = {0,cp,cmp,mh,accept,accept2,accept3,accept4,halt_accept,reject,reject2,reject3,reject4,reject5,halt_reject}
+#S = {0,1}
+#G = {0,1,_,t,r,u,e,f,a,l,s}
+#q0 = 0
+#B = _
+#F = {halt_accept}
+#N = 2
+
+0 0_ 0_ ** cp
+0 1_ 1_ ** cp
+0 __ __ ** accept
+
+cp 0_ 00 rr cp
+cp 1_ 11 rr cp
+cp __ __ ll mh
+
+mh 00 00 l* mh
+mh 01 01 l* mh
+mh 10 10 l* mh
+mh 11 11 l* mh
+mh _0 _0 r* cmp
+mh _1 _1 r* cmp
+
+cmp 00 __ rl cmp
+cmp 11 __ rl cmp
+cmp 01 __ rl reject
+cmp 10 __ rl reject
+cmp __ __ ** accept
+
+accept __ t_ r* accept2
+accept2 __ r_ r* accept3
+accept3 __ u_ r* accept4
+accept4 __ e_ ** halt_accept
+
+reject 00 __ rl reject
+reject 01 __ rl reject
+reject 10 __ rl reject
+reject 11 __ rl reject
+reject __ f_ r* reject2
+reject2 __ a_ r* reject3
+reject3 __ l_ r* reject4
+reject4 __ s_ r* reject5
+reject5 __ e_ ** halt_reject
+)";
+
+Machine parse(const char *source) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "persistent_tape_test.tm";
+  {
+    std::ofstream tm{path};
+    tm << source;
+  }
+  Machine machine = turing::parser::parse(path.string());
+  std::filesystem::remove(path);
+  return machine;
+}
+
+void testAgainstExecution(const Machine &machine) {
+  for (size_t length = 0; length <= 8; ++length) {
+    for (size_t bits = 0; bits < (size_t{1} << length); ++bits) {
+      std::string input;
+      for (size_t i = 0; i < length; ++i) {
+        input += (bits >> i & 1) ? '1' : '0';
+      }
+
+      Execution execution{machine, input};
+      PersistentTapes tapes{machine, input};
+      while (execution.step()) {
+        assert(tapes.step());
+        assert(tapes.currentState() == execution.tapes().currentState());
+      }
+      assert(!tapes.step());
+      assert(tapes.steps() == execution.tapes().steps());
+      assert(tapes.isAccepted() == execution.tapes().isAccepted());
+      assert(tapes.content() == execution.tapes().content());
+    }
+  }
+}
+
+void testFork(const Machine &machine) {
+  PersistentTapes tapes{machine, "1001101"};
+  for (int i = 0; i < 10; ++i) {
+    tapes.step();
+  }
+
+  PersistentTapes fork = tapes;
+  std::string state = tapes.currentState();
+  std::optional<std::string> content = tapes.content();
+  while (fork.step()) {
+  }
+  assert(fork.content() == "false");
+
+  // the original did not see the steps of its fork
+  assert(tapes.steps() == 10);
+  assert(tapes.currentState() == state);
+  assert(tapes.content() == content);
+
+  while (tapes.step()) {
+  }
+  assert(tapes.steps() == fork.steps());
+  assert(tapes.content() == fork.content());
+}
+
+void testStructuralSharing() {
+  std::string input(10000, 'a');
+  PersistentTape tape{input, '_'};
+  for (int i = 0; i < 5000; ++i) {
+    tape.move(Direction::RIGHT, '*');
+  }
+
+  PersistentTape copy = tape;
+  for (int i = 0; i < 10000; i += 64) {
+    assert(copy.shares(tape, i));
+  }
+
+  // a write copies the one chunk it touches
+  copy.move(Direction::STAY, 'b');
+  size_t shared = 0;
+  for (int i = 0; i < 10000; ++i) {
+    shared += copy.shares(tape, i);
+  }
+  assert(shared == 10000 - 64);
+  assert(!copy.shares(tape, 5000));
+  assert(copy.currentSign() == 'b' && tape.currentSign() == 'a');
+
+  // rewriting a cell with what it holds shares on
+  PersistentTape again = tape;
+  again.move(Direction::STAY, 'a');
+  assert(again.shares(tape, 5000));
+
+  // further writes to the copied chunk copy nothing
+  copy.move(Direction::RIGHT, 'c');
+  copy.move(Direction::RIGHT, 'd');
+  assert(copy.contentString()->substr(4998, 6) == "aacdaa");
+  assert(tape.contentString().value() == input);
+}
+
+void testCopyLeavesSourceAlone() {
+  PersistentTape tape{"abc", '_'};
+  tape.move(Direction::STAY, 'x');
+
+  // copying reads the source only, yet its next write to the chunk it
+  // already wrote must copy that chunk
+  const PersistentTape &source = tape;
+  PersistentTape copy = source;
+  tape.move(Direction::RIGHT, 'y');
+  assert(tape.contentString().value() == "ybc");
+  assert(copy.contentString().value() == "xbc");
+  assert(!copy.shares(tape, 0));
+
+  // the same once the copy wrote elsewhere: the roots are apart again, but
+  // the node above cell 0 is still shared
+  PersistentTape deep{std::string(5000, 'a'), '_'};
+  deep.move(Direction::STAY, 'b');
+  PersistentTape branch = deep;
+  for (int i = 0; i < 4999; ++i) {
+    branch.move(Direction::RIGHT, '*');
+  }
+  branch.move(Direction::STAY, 'z');
+  deep.move(Direction::STAY, 'd');
+  assert(branch.cellAt(0) == 'b' && deep.cellAt(0) == 'd');
+  assert(branch.shares(deep, 100) && !branch.shares(deep, 0));
+}
+
+void testLeftOfOrigin() {
+  PersistentTape tape{"xy", '_'};
+  for (int i = 0; i < 200; ++i) {
+    tape.move(Direction::LEFT, i % 2 ? 'p' : 'q');
+  }
+  assert(tape.head() == -200);
+  assert(tape.cellAt(-1) == 'p' && tape.cellAt(-200) == '_');
+
+  PersistentTape copy = tape;
+  copy.move(Direction::RIGHT, 'z');
+  assert(copy.cellAt(-200) == 'z' && tape.cellAt(-200) == '_');
+  assert(copy.shares(tape, -1));
+  assert(!copy.shares(tape, -200));
+
+  std::string content = tape.contentString().value();
+  assert(content.size() == 201);
+  assert(content.substr(content.size() - 3) == "pqy");
+
+  // blanks written at the ends are trimmed from the content
+  PersistentTape blank{"ab", '_'};
+  blank.move(Direction::RIGHT, '_');
+  blank.move(Direction::STAY, '_');
+  assert(blank.contentString().value_or("") == "");
+}
+
+int main() {
+  const Machine palindrome = parse(PALINDROME);
+  testAgainstExecution(palindrome);
+  testFork(palindrome);
+  testStructuralSharing();
+  testCopyLeavesSourceAlone();
+  testLeftOfOrigin();
+}
@@ -0,0 +1,210 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+#include "turing/machine/compiled.hpp"
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/observer.h"
+#include "turing/machine/profile.h"
+#include "turing/machine/symbols.h"
+#include "turing/machine/transition.h"
+
+using turing::machine::CompiledExecution;
+using turing::machine::CompiledMachine;
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::Profile;
+using turing::machine::ProfileObserver;
+using turing::machine::SymbolTable;
+using turing::machine::Transition;
+
+// Counts the 1s of a binary input in unary on tape 1. The '*' pattern of
+// count comes first but only fires on what no exact transition reads.
+Machine counter() {
+  return Machine{
+      {"count", "done"},
+      {'0', '1'},
+      {'0', '1', '_'},
+      "count",
+      '_',
+      {"done"},
+      2,
+      {{"count",
+        {Transition{"count", {'*', '_'}, {'*', '_'}, {Direction::RIGHT, Direction::STAY}, "count"},
+         Transition{"count", {'_', '_'}, {'_', '_'}, {Direction::STAY, Direction::STAY}, "done"},
+         Transition{"count", {'1', '_'}, {'1', '1'}, {Direction::RIGHT, Direction::RIGHT}, "count"},
+         Transition{"count", {'1', '_'}, {'0', '0'}, {Direction::RIGHT, Direction::RIGHT}, "count"}}}}};
+}
+
+// counter entered through a state that only fires once
+Machine primed() {
+  return Machine{
+      {"init", "count", "done"},
+      {'0', '1'},
+      {'0', '1', '_'},
+      "init",
+      '_',
+      {"done"},
+      2,
+      {{"init",
+        {Transition{"init", {'*', '*'}, {'*', '*'}, {Direction::STAY, Direction::STAY}, "count"}}},
+       {"count",
+        {Transition{"count", {'*', '_'}, {'*', '_'}, {Direction::RIGHT, Direction::STAY}, "count"},
+         Transition{"count", {'_', '_'}, {'_', '_'}, {Direction::STAY, Direction::STAY}, "done"},
+         Transition{"count", {'1', '_'}, {'1', '1'}, {Direction::RIGHT, Direction::RIGHT}, "count"}}}}};
+}
+
+std::string temporary(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// run machine on input writing a profile to path
+void record(const Machine &machine, const std::string &input,
+            const std::string &path) {
+  Execution execution{machine, input};
+  std::optional<ProfileObserver> profile{std::in_place, machine, path};
+  turing::machine::observe(execution, profile);
+  profile->finish();
+}
+
+size_t idOf(const Machine &machine, const std::string &statement) {
+  for (size_t id = 0; id < machine.nTransition(); ++id) {
+    if (turing::machine::statementOf(machine.transition(id)) == statement) {
+      return id;
+    }
+  }
+  assert(false);
+  return 0;
+}
+
+void testRoundTrip() {
+  const Machine machine = counter();
+  std::string path = temporary("profile_test.profile");
+  record(machine, "1101011", path);
+  Profile profile{machine, path};
+  std::filesystem::remove(path);
+
+  assert(profile.hits(idOf(machine, "count 1_ 11 rr count")) == 5);
+  assert(profile.hits(idOf(machine, "count 1_ 00 rr count")) == 0);
+  assert(profile.hits(idOf(machine, "count *_ *_ r* count")) == 2);
+  assert(profile.hits(idOf(machine, "count __ __ ** done")) == 1);
+}
+
+void testReorder() {
+  const Machine machine = counter();
+  std::string path = temporary("profile_test.profile");
+  record(machine, "1111111", path);
+  Profile profile{machine, path};
+  std::filesystem::remove(path);
+
+  // the hot exact transition moves up, its shadowed copy stays behind it
+  // and the pattern stays last
+  const Machine reordered = turing::machine::reorder(machine, profile);
+  assert(turing::machine::statementOf(reordered.transition(0)) ==
+         "count 1_ 11 rr count");
+  assert(turing::machine::statementOf(reordered.transition(1)) ==
+         "count 1_ 00 rr count");
+  assert(turing::machine::statementOf(reordered.transition(2)) ==
+         "count __ __ ** done");
+  assert(turing::machine::statementOf(reordered.transition(3)) ==
+         "count *_ *_ r* count");
+
+  for (std::string input : {"", "0", "1", "0110", "1110001", "00000"}) {
+    Execution before{machine, input};
+    Execution after{reordered, input};
+    while (before.step()) {
+    }
+    while (after.step()) {
+    }
+    assert(before.tapes().steps() == after.tapes().steps());
+    assert(before.tapes().isAccepted() == after.tapes().isAccepted());
+    assert(before.tapes().content() == after.tapes().content());
+  }
+}
+
+void testShadowedHits() {
+  // a profile of an edited file may credit the shadowed copy, which must
+  // still not overtake the transition that fires
+  const Machine machine = counter();
+  std::string path = temporary("profile_test.profile");
+  {
+    std::ofstream out{path};
+    out << "9 count 1_ 00 rr count\n";
+  }
+  Profile profile{machine, path};
+  std::filesystem::remove(path);
+
+  const Machine reordered = turing::machine::reorder(machine, profile);
+  assert(turing::machine::statementOf(reordered.transition(0)) ==
+         "count __ __ ** done");
+  assert(turing::machine::statementOf(reordered.transition(1)) ==
+         "count 1_ 11 rr count");
+  assert(turing::machine::statementOf(reordered.transition(2)) ==
+         "count 1_ 00 rr count");
+}
+
+void testCompiledLayout() {
+  const Machine machine = primed();
+  std::string path = temporary("profile_test.profile");
+  record(machine, "1011", path);
+  Profile profile{machine, path};
+  std::filesystem::remove(path);
+
+  const CompiledMachine plain{machine, SymbolTable{machine}};
+  const CompiledMachine laidOut{machine, SymbolTable{machine},
+                                         &profile};
+  // count is the hot state, with its most frequent transition first
+  assert(plain.startState() == 0);
+  assert(laidOut.startState() == 1);
+  assert(turing::machine::statementOf(machine.transition(laidOut.source(0))) ==
+         "count 1_ 11 rr count");
+
+  for (std::string input : {"", "1", "10", "0101", "111000111"}) {
+    CompiledExecution a{plain};
+    CompiledExecution b{laidOut};
+    a.reset(input);
+    b.reset(input);
+    while (a.step()) {
+    }
+    while (b.step()) {
+    }
+    assert(a.steps() == b.steps());
+    assert(a.isAccepted() == b.isAccepted());
+    assert(a.content() == b.content());
+  }
+}
+
+void testMismatch() {
+  const Machine machine = counter();
+  std::string path = temporary("profile_test.profile");
+  {
+    std::ofstream out{path};
+    out << "3 count 1_ 11 rr elsewhere\n";
+  }
+
+  bool thrown = false;
+  try {
+    Profile{machine, path};
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+  std::filesystem::remove(path);
+  assert(thrown);
+}
+
+int main() {
+  testRoundTrip();
+  testReorder();
+  testShadowedHits();
+  testCompiledLayout();
+  testMismatch();
+}
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/scheduler.h"
+#include "turing/machine/transition.h"
+
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::Scheduler;
+using turing::machine::Tapes;
+using turing::machine::Transition;
+
+// walks right over the input, then halts in accept
+Machine scanner() {
+  return Machine{{"scan", "accept"},
+                 {'1'},
+                 {'1', '_'},
+                 "scan",
+                 '_',
+                 {"accept"},
+                 1,
+                 {{"scan",
+                   {Transition{"scan", {'1'}, {'1'}, {Direction::RIGHT}, "scan"},
+                    Transition{"scan", {'_'}, {'_'}, {Direction::STAY}, "accept"}}}}};
+}
+
+void testSteps() {
+  const Machine machine = scanner();
+  Execution execution{machine, "1111111"};
+
+  std::vector<size_t> yielded;
+  for (const Tapes &tapes : execution.steps(3)) {
+    yielded.push_back(tapes.steps());
+  }
+  assert((yielded == std::vector<size_t>{3, 6, 8}));
+  assert(execution.isHalted() && execution.tapes().isAccepted());
+
+  Execution limited{machine, "1111111"};
+  yielded.clear();
+  for (const Tapes &tapes : limited.steps(3, 5)) {
+    yielded.push_back(tapes.steps());
+  }
+  assert((yielded == std::vector<size_t>{3, 5}));
+  assert(!limited.isHalted());
+}
+
+void testScheduler() {
+  const Machine machine = scanner();
+  std::atomic<size_t> done = 0;
+  std::atomic<size_t> exhausted = 0;
+
+  {
+    Scheduler scheduler{4, 64};
+    for (size_t i = 0; i < 1000; ++i) {
+      std::string input(i % 7 == 0 ? 5000 : i % 50, '1');
+      scheduler.submit(
+          std::make_unique<Execution>(machine, input),
+          [&done, &exhausted, size = input.size()](
+              std::unique_ptr<Execution> execution, std::exception_ptr error) {
+            assert(!error);
+            if (execution->isHalted()) {
+              assert(execution->tapes().steps() == size + 1);
+              ++done;
+            } else {
+              assert(execution->tapes().steps() == 1000);
+              ++exhausted;
+            }
+          },
+          1000);
+    }
+  }
+
+  assert(done == 1000 - 143);
+  assert(exhausted == 143);
+}
+
+int main() {
+  testSteps();
+  testScheduler();
+}
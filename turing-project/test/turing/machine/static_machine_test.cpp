@@ -0,0 +1,137 @@
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/static_machine.hpp"
+#include "turing/parser/parser.hpp"
+
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::StaticMachine;
+
+// programs/palindrome_detector_2tapes.tm
+constexpr char PALINDROME[] = R"(
+; This example program checks if the input string is a binary palindrome.
+#Q = {0,cp,cmp,mh,accept,accept2,accept3,accept4,halt_accept,reject,reject2,reject3,reject4,reject5,halt_reject}
+#S = {0,1}
+#G = {0,1,_,t,r,u,e,f,a,l,s}
+#q0 = 0
+#B = _
+#F = {halt_accept}
+#N = 2
+
+0 0_ 0_ ** cp
+0 1_ 1_ ** cp
+0 __ __ ** accept ; empty input
+
+cp 0_ 00 rr cp
+cp 1_ 11 rr cp
+cp __ __ ll mh
+
+mh 00 00 l* mh
+mh 01 01 l* mh
+mh 10 10 l* mh
+mh 11 11 l* mh
+mh _0 _0 r* cmp
+mh _1 _1 r* cmp
+
+cmp 00 __ rl cmp
+cmp 11 __ rl cmp
+cmp 01 __ rl reject
+cmp 10 __ rl reject
+cmp __ __ ** accept
+
+accept __ t_ r* accept2
+accept2 __ r_ r* accept3
+accept3 __ u_ r* accept4
+accept4 __ e_ ** halt_accept
+
+reject 00 __ rl reject
+reject 01 __ rl reject
+reject 10 __ rl reject
+reject 11 __ rl reject
+reject __ f_ r* reject2
+reject2 __ a_ r* reject3
+reject3 __ l_ r* reject4
+reject4 __ s_ r* reject5
+reject5 __ e_ ** halt_reject
+)";
+
+// erases every 1, skipping 0 through the '*' pattern
+constexpr char ERASER[] = R"(
+#Q = {scan,done}
+#S = {0,1}
+#G = {0,1,_}
+#q0 = scan
+#B = _
+#F = {done}
+#N = 1
+scan 1 _ r scan
+scan * * r scan
+scan _ _ * done
+)";
+
+using Palindrome = StaticMachine<PALINDROME>;
+using Eraser = StaticMachine<ERASER>;
+
+static_assert(Palindrome::N_STATE == 15);
+static_assert(Palindrome::N_TAPE == 2);
+static_assert(Palindrome::N_TRANSITION == 30);
+static_assert(Palindrome::isInputValid("1001"));
+static_assert(!Palindrome::isInputValid("102"));
+
+void testAgainstMachine() {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "static_machine_test.tm";
+  {
+    std::ofstream tm{path};
+    tm << PALINDROME;
+  }
+  const Machine machine = turing::parser::parse(path.string());
+  std::filesystem::remove(path);
+
+  for (size_t length = 0; length <= 8; ++length) {
+    for (size_t bits = 0; bits < (size_t{1} << length); ++bits) {
+      std::string input;
+      for (size_t i = 0; i < length; ++i) {
+        input += (bits >> i & 1) ? '1' : '0';
+      }
+
+      Execution execution{machine, input};
+      while (execution.step()) {
+      }
+      Palindrome::Result result = Palindrome::run(input);
+
+      assert(result.halted);
+      assert(result.steps == execution.tapes().steps());
+      assert(result.accepted == execution.tapes().isAccepted());
+      assert(result.content == execution.tapes().content().value_or(""));
+      assert(result.content == (std::string(input.rbegin(), input.rend()) == input
+                                    ? "true"
+                                    : "false"));
+    }
+  }
+}
+
+void testStarPattern() {
+  Eraser::Result result = Eraser::run("10110");
+  assert(result.halted && result.accepted);
+  assert(result.steps == 6);
+  assert(result.content == "0__0");
+}
+
+void testMaxSteps() {
+  Palindrome::Result result = Palindrome::run("0110", 3);
+  assert(!result.halted && !result.accepted);
+  assert(result.steps == 3);
+}
+
+int main() {
+  testAgainstMachine();
+  testStarPattern();
+  testMaxSteps();
+}
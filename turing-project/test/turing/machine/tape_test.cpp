@@ -0,0 +1,215 @@
+#include <cassert>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include "turing/machine/alphabet.h"
+#include "turing/machine/direction.h"
+#include "turing/machine/stream.h"
+#include "turing/machine/tape.h"
+
+using turing::machine::Alphabet;
+using turing::machine::Direction;
+using turing::machine::StreamInput;
+using turing::machine::Tape;
+using turing::machine::TapeRecord;
+
+void testInput() {
+  Tape tape{"abc", '_'};
+  assert(tape.currentSign() == 'a');
+  assert(tape.contentView() == std::optional<std::string_view>{"abc"});
+
+  Tape empty{"", '_'};
+  assert(empty.currentSign() == '_');
+  assert(!empty.contentView().has_value());
+  auto records = empty.content(true);
+  assert(records.has_value() && records->size() == 1 && records->at(0).isHead);
+}
+
+void testGrowLeft() {
+  Tape tape{'_'};
+  for (int i = 0; i < 10; ++i) {
+    tape.move(Direction::LEFT, 'x');
+  }
+  assert(tape.currentSign() == '_');
+  assert(tape.contentView() == std::optional<std::string_view>{"xxxxxxxxxx"});
+
+  auto records = tape.content(true);
+  assert(records.has_value());
+  assert(records->front().index == -10 && records->front().isHead);
+  assert(records->back().index == 0 && records->back().sign == 'x');
+}
+
+void testTrim() {
+  Tape tape{"abcd", '_'};
+  tape.move(Direction::RIGHT, '_');
+  tape.move(Direction::RIGHT, '*');
+  tape.move(Direction::RIGHT, '_');
+  assert(tape.contentView() == std::optional<std::string_view>{"b_d"});
+
+  tape.move(Direction::LEFT, '_');
+  assert(tape.contentView() == std::optional<std::string_view>{"b"});
+  tape.move(Direction::LEFT, '_');
+  tape.move(Direction::LEFT, '_');
+  assert(!tape.contentView().has_value());
+
+  // the head is kept even when it is outside of the non-blank range
+  tape.move(Direction::STAY, 'y');
+  auto records = tape.content(true);
+  assert(records.has_value() && records->size() == 1);
+  assert(records->at(0).index == 0 && records->at(0).sign == 'y');
+}
+
+void testStream() {
+  std::string input;
+  for (int i = 0; i < 300000; ++i) {
+    input += static_cast<char>('a' + i % 7);
+  }
+
+  std::FILE *file = std::tmpfile();
+  std::fwrite(input.data(), 1, input.size(), file);
+  std::fputs("\n", file);
+  std::rewind(file);
+
+  Alphabet alphabet{{'a', 'b', 'c', 'd', 'e', 'f', 'g'}};
+  StreamInput stream{fileno(file), alphabet};
+  Tape tape{stream, '_', 1000};
+
+  // upper-case every cell on the way right, spilling most of them, then
+  // walk back past the start so that all of them are read back
+  for (size_t i = 0; i < input.size(); ++i) {
+    assert(tape.currentSign() == input[i]);
+    tape.move(Direction::RIGHT, input[i] - 'a' + 'A');
+  }
+  assert(tape.currentSign() == '_');
+  for (size_t i = input.size(); i > 0; --i) {
+    tape.move(Direction::LEFT, '*');
+    assert(tape.currentSign() == input[i - 1] - 'a' + 'A');
+  }
+  tape.move(Direction::LEFT, '*');
+  tape.move(Direction::STAY, 'x');
+
+  std::string expected = "x";
+  for (char ch : input) {
+    expected += ch - 'a' + 'A';
+  }
+  assert(tape.contentString() == expected);
+
+  std::fclose(file);
+}
+
+void testSpillLeftOfOrigin() {
+  std::string input(50000, 'a');
+  std::FILE *file = std::tmpfile();
+  std::fwrite(input.data(), 1, input.size(), file);
+  std::rewind(file);
+
+  Alphabet alphabet{{'a'}};
+  StreamInput stream{fileno(file), alphabet};
+  Tape tape{stream, '_', 1000};
+
+  // cells left of 0 are spilled and read back like the others
+  for (int i = 0; i < 5000; ++i) {
+    tape.move(Direction::LEFT, i == 0 ? '*' : 'l');
+  }
+  assert(tape.head() == -5000);
+  for (int i = -5000; i < 50000; ++i) {
+    tape.move(Direction::RIGHT, '*');
+  }
+  for (int i = 50000; i > -4999; --i) {
+    tape.move(Direction::LEFT, '*');
+  }
+  assert(tape.head() == -4999 && tape.currentSign() == 'l');
+  assert(tape.contentString() == std::string(4999, 'l') + input);
+
+  std::fclose(file);
+}
+
+void testStreamRest() {
+  std::string input;
+  for (int i = 0; i < 200000; ++i) {
+    input += static_cast<char>('a' + i % 3);
+  }
+
+  std::FILE *file = std::tmpfile();
+  std::fwrite(input.data(), 1, input.size(), file);
+  std::fputs("__", file);
+  std::rewind(file);
+
+  Alphabet alphabet{{'a', 'b', 'c', '_'}};
+  StreamInput stream{fileno(file), alphabet};
+  Tape tape{stream, '_'};
+  tape.move(Direction::STAY, '_');
+
+  // the unread rest of the input still belongs to the content
+  assert(tape.contentString() == input.substr(1));
+
+  std::fclose(file);
+}
+
+// what tape.writeContent writes, or nullopt when it writes nothing
+std::optional<std::string> written(const Tape &tape, std::string_view prefix,
+                                   std::string_view suffix) {
+  std::FILE *file = std::tmpfile();
+  bool wrote = tape.writeContent(fileno(file), prefix, suffix);
+
+  std::string content(lseek(fileno(file), 0, SEEK_END), '\0');
+  ssize_t n = pread(fileno(file), content.data(), content.size(), 0);
+  assert(n == static_cast<ssize_t>(content.size()));
+  std::fclose(file);
+
+  assert(wrote == !content.empty());
+  return wrote ? std::optional<std::string>{content} : std::nullopt;
+}
+
+void testWriteContent() {
+  Tape blank{'_'};
+  blank.move(Direction::RIGHT, '_');
+  assert(written(blank, "Result: ", "\n") == std::nullopt);
+
+  Tape tape{"abcd", '_'};
+  tape.move(Direction::RIGHT, 'x');
+  tape.move(Direction::STAY, '_');
+  assert(written(tape, "Result: ", "\n") == "Result: x_cd\n");
+
+  // spilled cells, cells in memory and the unread rest with blanks in it
+  std::string input;
+  for (int i = 0; i < 300000; ++i) {
+    input += i % 1000 < 10 ? '_' : static_cast<char>('a' + i % 3);
+  }
+  std::FILE *file = std::tmpfile();
+  std::fwrite(input.data(), 1, input.size(), file);
+  std::fputs("___\n", file);
+  std::rewind(file);
+
+  Alphabet alphabet{{'a', 'b', 'c', '_'}};
+  StreamInput stream{fileno(file), alphabet};
+  Tape streamed{stream, '_', 1000};
+  for (size_t i = 0; i < 100000; ++i) {
+    streamed.move(Direction::RIGHT, input[i] == '_' ? '_' : 'A');
+  }
+
+  std::string expected = input;
+  for (size_t i = 0; i < 100000; ++i) {
+    expected[i] = input[i] == '_' ? '_' : 'A';
+  }
+  expected = expected.substr(10);
+  assert(written(streamed, "(ACCEPTED) ", "\n") ==
+         "(ACCEPTED) " + expected + "\n");
+
+  std::fclose(file);
+}
+
+int main() {
+  testInput();
+  testGrowLeft();
+  testTrim();
+  testStream();
+  testSpillLeftOfOrigin();
+  testStreamRest();
+  testWriteContent();
+}
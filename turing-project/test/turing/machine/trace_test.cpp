@@ -0,0 +1,82 @@
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+#include "turing/machine/direction.h"
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/machine/trace.h"
+#include "turing/machine/transition.h"
+
+using turing::machine::Direction;
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::machine::TraceFilter;
+using turing::machine::TraceOption;
+using turing::machine::Transition;
+
+// moves the input from tape 0 to tape 1, then rewinds tape 1 and accepts
+Machine mover() {
+  return Machine{
+      {"move", "rewind", "accept"},
+      {'a', 'b'},
+      {'a', 'b', '_'},
+      "move",
+      '_',
+      {"accept"},
+      2,
+      {{"move",
+        {Transition{"move", {'a', '_'}, {'_', 'a'},
+                    {Direction::RIGHT, Direction::RIGHT}, "move"},
+         Transition{"move", {'b', '_'}, {'_', 'b'},
+                    {Direction::RIGHT, Direction::RIGHT}, "move"},
+         Transition{"move", {'_', '_'}, {'_', '_'},
+                    {Direction::STAY, Direction::LEFT}, "rewind"}}},
+       {"rewind",
+        {Transition{"rewind", {'_', '_'}, {'_', '_'},
+                    {Direction::STAY, Direction::RIGHT}, "accept"},
+         Transition{"rewind", {'_', '*'}, {'*', '*'},
+                    {Direction::STAY, Direction::LEFT}, "rewind"}}}}};
+}
+
+// steps of a run on "ab" the filter selects
+std::vector<size_t> selected(const TraceOption &option) {
+  const Machine machine = mover();
+  TraceFilter filter{machine, option};
+  Execution execution{machine, "ab"};
+
+  std::vector<size_t> steps;
+  if (filter.selectStart()) {
+    steps.push_back(0);
+  }
+  while (const Transition *next = execution.next()) {
+    bool select = filter.select(*next, execution.tapes());
+    execution.step();
+    if (select) {
+      steps.push_back(execution.tapes().steps());
+    }
+  }
+  return steps;
+}
+
+int main() {
+  assert((selected({}) == std::vector<size_t>{0, 1, 2, 3, 4, 5, 6}));
+  assert((selected({.every = 2}) == std::vector<size_t>{0, 2, 4, 6}));
+  assert((selected({.states = {"rewind", "accept"}}) ==
+          std::vector<size_t>{3, 6}));
+  // only the moves write tape 1, rewinding keeps its cells
+  assert((selected({.tape = 1}) == std::vector<size_t>{1, 2}));
+  assert((selected({.every = 2, .tape = 0}) == std::vector<size_t>{2}));
+
+  const Machine machine = mover();
+  try {
+    TraceFilter{machine, {.states = {"nowhere"}}};
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+  try {
+    TraceFilter{machine, {.tape = 2}};
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+}
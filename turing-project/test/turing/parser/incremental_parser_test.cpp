@@ -0,0 +1,95 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/parser/exception.h"
+#include "turing/parser/incremental_parser.h"
+
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::parser::IncrementalParser;
+
+const std::filesystem::path PATH =
+    std::filesystem::temp_directory_path() / "incremental_parser_test.tm";
+
+const std::string HEADER = "#Q = {scan,done}\n"
+                           "#S = {0,1}\n"
+                           "#G = {0,1,_}\n"
+                           "#q0 = scan\n"
+                           "#B = _\n"
+                           "#F = {done}\n"
+                           "#N = 1\n";
+
+void write(const std::string &source) {
+  std::ofstream tm{PATH};
+  tm << source;
+}
+
+std::string run(const Machine &machine, const std::string &input) {
+  Execution execution{machine, input};
+  while (execution.step()) {
+  }
+  return execution.tapes().content().value_or("");
+}
+
+int main() {
+  // flips every bit
+  write(HEADER + "scan 0 1 r scan\n"
+                 "scan 1 0 r scan\n"
+                 "scan _ _ * done\n");
+  IncrementalParser parser{PATH.string()};
+  Machine flip = parser.parse();
+  assert(parser.reparsed() == 10);
+  assert(run(flip, "0110") == "1001");
+
+  // erases ones instead: one line edited, one moved
+  write(HEADER + "scan _ _ * done\n"
+                 "scan 0 0 r scan\n"
+                 "scan 1 _ r scan\n");
+  Machine erase = parser.parse();
+  assert(parser.reparsed() == 2);
+  assert(run(erase, "0110") == "0__0");
+  // the old machine is untouched
+  assert(run(flip, "0110") == "1001");
+
+  // a syntax error keeps the last version's lines
+  write(HEADER + "scan _ _ * done\n"
+                 "scan 0 0 r\n");
+  bool failed = false;
+  try {
+    parser.parse();
+  } catch (const turing::parser::InvalidSyntaxException &) {
+    failed = true;
+  }
+  assert(failed);
+
+  write(HEADER + "scan _ _ * done\n"
+                 "scan 0 0 r scan\n"
+                 "scan 1 _ r scan\n");
+  Machine again = parser.parse();
+  assert(parser.reparsed() == 0);
+  assert(run(again, "0110") == "0__0");
+
+  // every save renames the final state; names and results of the lines it
+  // replaced do not pile up
+  std::optional<Machine> renamed;
+  for (int i = 0; i < 300; ++i) {
+    std::string done = "done" + std::to_string(i);
+    write("#Q = {scan," + done + "}\n#S = {0,1}\n#G = {0,1,_}\n#q0 = scan\n"
+          "#B = _\n#F = {" + done + "}\n#N = 1\n"
+          "scan 0 1 r scan\n"
+          "scan 1 0 r scan\n"
+          "scan _ _ * " + done + "\n");
+    renamed.emplace(parser.parse());
+    assert(parser.interned() <= 64);
+  }
+  assert(run(*renamed, "0110") == "1001");
+  assert(renamed->finalStates().contains("done299"));
+
+  std::filesystem::remove(PATH);
+}
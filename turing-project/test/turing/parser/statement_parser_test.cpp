@@ -2,25 +2,44 @@
 #include "turing/machine/transition.h"
 #include "turing/parser/result.h"
 #include "turing/parser/statement_parser.h"
+#include "turing/parser/string_table.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
 #include <unordered_set>
 #include <variant>
 
+std::pmr::monotonic_buffer_resource arena;
+turing::parser::StringTable names{&arena};
+
+turing::parser::StatementResult parseStatement(const std::string &statement) {
+  return turing::parser::parseStatement(statement, names, &arena);
+}
+
+std::unordered_set<std::string> toSet(const std::pmr::vector<std::string_view> &views) {
+  std::unordered_set<std::string> set;
+  for (std::string_view view : views) {
+    set.emplace(view);
+  }
+  return set;
+}
+
 void testEmpty(const std::string &&statement) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::EmptyStatementResult>(statementResult));
 }
 
 void testComment(const std::string &&statement) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::CommentStatementResult>(statementResult));
 }
 
 void testParseNTape(const std::string &&statement, const size_t nTape) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::NTapeResult>(normalStatementResult));
@@ -29,7 +48,7 @@ void testParseNTape(const std::string &&statement, const size_t nTape) {
 }
 
 void testBlankSymbol(const std::string &&statement, char blankSymbol) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::BlankSymbolResult>(normalStatementResult));
@@ -38,7 +57,7 @@ void testBlankSymbol(const std::string &&statement, char blankSymbol) {
 }
 
 void testStartState(const std::string &&statement, std::string &&startState) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::StartStateResult>(normalStatementResult));
@@ -47,16 +66,16 @@ void testStartState(const std::string &&statement, std::string &&startState) {
 }
 
 void testFinalStates(const std::string &&statement, std::unordered_set<std::string> &&finalStates) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::FinalStatesResult>(normalStatementResult));
   turing::parser::FinalStatesResult result = std::get<turing::parser::FinalStatesResult>(normalStatementResult);
-  assert(result.finalStates == finalStates);
+  assert(toSet(result.finalStates) == finalStates);
 }
 
 void testInputAlphabet(const std::string &&statement, std::unordered_set<char> &&inputAlphabet) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::InputAlphabetResult>(normalStatementResult));
@@ -65,7 +84,7 @@ void testInputAlphabet(const std::string &&statement, std::unordered_set<char> &
 }
 
 void testTapeAlphabet(const std::string &&statement, std::unordered_set<char> &&tapeAlphabet) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::TapeAlphabetResult>(normalStatementResult));
@@ -74,19 +93,32 @@ void testTapeAlphabet(const std::string &&statement, std::unordered_set<char> &&
 }
 
 void testStates(const std::string &&statement, std::unordered_set<std::string> &&states) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::NormalStatementResult>(statementResult));
   turing::parser::NormalStatementResult normalStatementResult = std::get<turing::parser::NormalStatementResult>(statementResult);
   assert(std::holds_alternative<turing::parser::StatesResult>(normalStatementResult));
   turing::parser::StatesResult result = std::get<turing::parser::StatesResult>(normalStatementResult);
-  assert(result.states == states);
+  assert(toSet(result.states) == states);
 }
 
 void testTransition(const std::string &&statement, turing::machine::Transition transition) {
-  turing::parser::StatementResult statementResult = turing::parser::parseStatement(statement);
+  turing::parser::StatementResult statementResult = parseStatement(statement);
   assert(std::holds_alternative<turing::parser::TransitionStatementResult>(statementResult));
   turing::parser::TransitionStatementResult result = std::get<turing::parser::TransitionStatementResult>(statementResult);
-  assert(result.transition == transition);
+  assert(turing::parser::toTransition(result) == transition);
+}
+
+void testInterning() {
+  std::string_view cp = names.intern("cp");
+
+  turing::parser::StatementResult statementResult = parseStatement("cp 0_ 00 rr cp");
+  turing::parser::TransitionStatementResult result = std::get<turing::parser::TransitionStatementResult>(statementResult);
+  assert(result.oldState.data() == cp.data());
+  assert(result.newState.data() == cp.data());
+
+  size_t size = names.size();
+  parseStatement("#q0 = cp");
+  assert(names.size() == size);
 }
 
 int main() {
@@ -122,6 +154,9 @@ int main() {
   
   testTapeAlphabet("#G = {0,1,_,t,r,u,e,f,a,l,s}", {'0', '1', '_', 't', 'r', 'u', 'e', 'f', 'a', 'l', 's'});
   
+  testStates("#Q = {a,b,a}", {"a", "b"});
+  testInterning();
+
   testStates("#Q = {0,cp,cmp,mh,accept,accept2,accept3,accept4,halt_accept,reject,reject2,reject3,reject4,reject5,halt_reject}", {"0", "cp", "cmp", "mh", "accept", "accept2", "accept3", "accept4", "halt_accept", "reject", "reject2", "reject3", "reject4", "reject5", "halt_reject"});
   
   testTransition("0 0_ 0_ ** cp", turing::machine::Transition{
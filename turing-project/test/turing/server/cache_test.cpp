@@ -0,0 +1,102 @@
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "turing/machine/execution.h"
+#include "turing/machine/machine.h"
+#include "turing/server/cache.h"
+
+using turing::machine::Execution;
+using turing::machine::Machine;
+using turing::server::MachineCache;
+
+const std::string HEADER = "#Q = {scan,done}\n"
+                           "#S = {0,1}\n"
+                           "#G = {0,1,_}\n"
+                           "#q0 = scan\n"
+                           "#B = _\n"
+                           "#F = {done}\n"
+                           "#N = 1\n";
+
+// rewrites every 0 to symbol, keeping the ones
+std::string write(const std::string &name, char symbol) {
+  std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::ofstream tm{path};
+  tm << HEADER << "scan 0 " << symbol << " r scan\n"
+     << "scan 1 1 r scan\n"
+     << "scan _ _ * done\n";
+  return path.string();
+}
+
+std::string run(const Machine &machine, const std::string &input) {
+  Execution execution{machine, input};
+  while (execution.step()) {
+  }
+  return execution.tapes().content().value_or("");
+}
+
+void testReuse() {
+  std::string path = write("cache_test_reuse.tm", '1');
+  MachineCache cache{2};
+
+  auto machine = cache.get(path);
+  assert(run(*machine, "010") == "111");
+  // an unchanged file is not parsed again
+  assert(cache.get(path) == machine);
+
+  // a newer mtime reloads it, while the old machine stays usable
+  write("cache_test_reuse.tm", '0');
+  std::filesystem::last_write_time(
+      path, std::filesystem::last_write_time(path) + std::chrono::seconds{1});
+  auto edited = cache.get(path);
+  assert(edited != machine);
+  assert(run(*edited, "010") == "010");
+  assert(run(*machine, "010") == "111");
+  assert(cache.get(path) == edited);
+
+  std::filesystem::remove(path);
+}
+
+void testEviction() {
+  std::string a = write("cache_test_a.tm", '1');
+  std::string b = write("cache_test_b.tm", '1');
+  std::string c = write("cache_test_c.tm", '1');
+  MachineCache cache{2};
+
+  auto first = cache.get(a);
+  auto second = cache.get(b);
+  // a becomes the most recently used, so c evicts b
+  assert(cache.get(a) == first);
+  cache.get(c);
+  assert(cache.get(a) == first);
+
+  // b is parsed again, and evicts c
+  auto reloaded = cache.get(b);
+  assert(reloaded != second);
+  assert(cache.get(a) == first);
+  assert(cache.get(b) == reloaded);
+
+  for (const std::string &path : {a, b, c}) {
+    std::filesystem::remove(path);
+  }
+}
+
+void testMissingFile() {
+  MachineCache cache{2};
+  try {
+    cache.get((std::filesystem::temp_directory_path() / "cache_test_none.tm")
+                  .string());
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+}
+
+int main() {
+  testReuse();
+  testEviction();
+  testMissingFile();
+}
@@ -0,0 +1,38 @@
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+#include "turing/util/generator.hpp"
+
+turing::util::Generator<const int &> countTo(int n) {
+  for (int i = 1; i <= n; ++i) {
+    co_yield i;
+  }
+}
+
+turing::util::Generator<const int &> failAfter(int n) {
+  for (int i = 1; i <= n; ++i) {
+    co_yield i;
+  }
+  throw std::runtime_error("failed");
+}
+
+int main() {
+  std::vector<int> values;
+  for (int value : countTo(5)) {
+    values.push_back(value);
+  }
+  assert((values == std::vector<int>{1, 2, 3, 4, 5}));
+
+  auto empty = countTo(0);
+  assert(!empty.next());
+  assert(!empty.next());
+
+  auto failing = failAfter(1);
+  assert(failing.next() && failing.value() == 1);
+  try {
+    failing.next();
+    assert(false);
+  } catch (const std::runtime_error &) {
+  }
+}
@@ -0,0 +1,59 @@
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+#include "turing/util/json.h"
+
+namespace json = turing::util::json;
+
+void testInvalid(const std::string &&text) {
+  try {
+    json::parse(text);
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+}
+
+int main() {
+  json::Value value = json::parse(
+      R"( {"id": 7, "tm": "programs/case1.tm", "input": "a\"b\\n\u0041",
+           "options": {"maxSteps": 100, "verbose": false}, "tags": [1, null]} )");
+  assert(std::holds_alternative<json::Object>(value.data));
+
+  const json::Object &object = std::get<json::Object>(value.data);
+  assert(std::get<double>(object.at("id").data) == 7);
+  assert(std::get<std::string>(object.at("tm").data) == "programs/case1.tm");
+  assert(std::get<std::string>(object.at("input").data) == "a\"b\\nA");
+
+  const json::Object &options = std::get<json::Object>(object.at("options").data);
+  assert(std::get<double>(options.at("maxSteps").data) == 100);
+  assert(std::get<bool>(options.at("verbose").data) == false);
+
+  const json::Array &tags = std::get<json::Array>(object.at("tags").data);
+  assert(tags.size() == 2);
+  assert(std::holds_alternative<json::Null>(tags[1].data));
+
+  assert(std::holds_alternative<json::Object>(json::parse("{}").data));
+  assert(std::get<json::Array>(json::parse("[]").data).empty());
+
+  testInvalid("");
+  testInvalid("{");
+  testInvalid("{\"a\" 1}");
+  testInvalid("[1,]");
+  testInvalid("{} x");
+  testInvalid("tru");
+  // bytes past ASCII are neither digits nor whitespace
+  testInvalid("1\xe9");
+  testInvalid("\xa0 1");
+  assert(std::get<std::string>(json::parse("\"\xc3\xa9\"").data) == "\xc3\xa9");
+
+  // nesting is bounded instead of recursing until the stack runs out
+  std::string nested = std::string(100, '[') + std::string(100, ']');
+  assert(std::holds_alternative<json::Array>(json::parse(nested).data));
+  testInvalid(std::string(100000, '['));
+  testInvalid(std::string(300, '[') + std::string(300, ']'));
+
+  assert(json::quote("a\"b\\c\nd") == "\"a\\\"b\\\\c\\nd\"");
+  assert(json::quote(std::string{'\x01'}) == "\"\\u0001\"");
+}